@@ -45,6 +45,8 @@ struct _GtAppPrivate
     GCancellable* open_channel_cancel;
 };
 
+GtApp* main_app;
+gchar* ORIGINAL_LOCALE;
 gint LOG_LEVEL = GT_LOG_LEVEL_MESSAGE;
 gboolean NO_FANCY_LOGGING = FALSE;
 gboolean VERSION = FALSE;
@@ -384,6 +386,7 @@ startup(GApplication* app)
 
     MESSAGE("Startup, running version '%s'", GT_VERSION);
 
+    self->scheduler = gt_channel_scheduler_new();
     self->fav_mgr = gt_follows_manager_new();
     self->twitch = gt_twitch_new();
 
@@ -421,14 +424,8 @@ startup(GApplication* app)
 static void
 shutdown(GApplication* app)
 {
-    GtApp* self = GT_APP(app);
-
     MESSAGE("Shutting down");
 
-    //TODO: Add a setting to allow user to use local follows even when logged in
-    if (!gt_app_is_logged_in(self))
-        gt_follows_manager_save(self->fav_mgr);
-
     G_APPLICATION_CLASS(gt_app_parent_class)->shutdown(app);
 }
 
@@ -29,6 +29,7 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE(GtApp, gt_app, GT, APP, GtkApplication)
 
 #include "gt-follows-manager.h"
+#include "gt-channel-scheduler.h"
 #include "gt-irc.h"
 
 typedef struct
@@ -76,6 +77,7 @@ struct _GtApp
 
     GtTwitch* twitch;
     GtFollowsManager* fav_mgr;
+    GtChannelScheduler* scheduler;
     GSettings* settings;
 
     PeasEngine* players_engine;
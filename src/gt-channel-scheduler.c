@@ -0,0 +1,373 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-channel-scheduler.h"
+#include "gt-app.h"
+#include "utils.h"
+
+#define TAG "GtChannelScheduler"
+#include "gnome-twitch/gt-log.h"
+
+#define WHEEL_TICK 5 /* NOTE: In seconds */
+#define JITTER_SLOTS 1
+#define LIVE_STREAMS_BATCH 100
+#define OFFLINE_DATA_MAX_AGE (G_TIME_SPAN_MINUTE*30)
+
+/* NOTE: Channels are kept on a timer wheel with one slot per tick,
+ * a full turn of the wheel is one refresh interval. Each tick takes
+ * the channels in the current slot, asks for them in bulk and puts
+ * them back a turn later give or take some jitter. */
+struct _GtChannelSchedulerPrivate
+{
+    GList** slots;
+    guint n_slots;
+    guint cursor;
+
+    GHashTable* channels; /* NOTE: Reffed channel to its slot */
+
+    guint tick_id;
+    GCancellable* cancel;
+};
+
+typedef struct
+{
+    GtChannelScheduler* self;
+    GList* channels;
+} RefreshBatch;
+
+G_DEFINE_TYPE_WITH_PRIVATE(GtChannelScheduler, gt_channel_scheduler, G_TYPE_OBJECT)
+
+enum
+{
+    SIG_CHANNELS_REFRESHED,
+    NUM_SIGS
+};
+
+static guint sigs[NUM_SIGS];
+
+GtChannelScheduler*
+gt_channel_scheduler_new(void)
+{
+    return g_object_new(GT_TYPE_CHANNEL_SCHEDULER, NULL);
+}
+
+static void
+refresh_batch_free(RefreshBatch* batch)
+{
+    gt_channel_list_free(batch->channels);
+
+    g_slice_free(RefreshBatch, batch);
+}
+
+static void
+fetch_live_streams_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    RefreshBatch* batch = udata;
+    g_autoptr(GHashTable) live = NULL;
+    g_autoptr(GError) err = NULL;
+    GList* streams = NULL;
+    GList* live_channels = NULL;
+
+    streams = gt_twitch_fetch_live_streams_finish(GT_TWITCH(source), res, &err);
+
+    if (err)
+    {
+        if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            WARNING("Unable to refresh channels because: %s", err->message);
+
+        goto finish;
+    }
+
+    live = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) gt_channel_data_free);
+
+    for (GList* l = streams; l != NULL; l = l->next)
+    {
+        GtChannelData* data = l->data;
+
+        g_hash_table_replace(live, data->id, data);
+    }
+
+    g_list_free(streams);
+
+    for (GList* l = batch->channels; l != NULL; l = l->next)
+    {
+        GtChannel* chan = l->data;
+        GtChannelData* data = g_hash_table_lookup(live, gt_channel_get_id(chan));
+
+        if (data)
+        {
+            g_hash_table_steal(live, data->id);
+
+            gt_channel_update_from_data(chan, data);
+
+            live_channels = g_list_prepend(live_channels, chan);
+        }
+        /* NOTE: Only channels that just went offline or haven't been
+         * looked at in a while need their offline data fetched */
+        else if (gt_channel_is_online(chan) ||
+            gt_channel_get_data_age(chan) > OFFLINE_DATA_MAX_AGE)
+        {
+            gt_channel_update(chan);
+        }
+    }
+
+    g_signal_emit(batch->self, sigs[SIG_CHANNELS_REFRESHED], 0, batch->channels, live_channels);
+
+    g_list_free(live_channels);
+
+finish:
+    refresh_batch_free(batch);
+}
+
+static void
+refresh_channels(GtChannelScheduler* self, GList* due)
+{
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+    GList* l = due;
+
+    while (l != NULL)
+    {
+        RefreshBatch* batch = g_slice_new0(RefreshBatch);
+        GList* ids = NULL;
+
+        batch->self = self;
+
+        for (gint i = 0; l != NULL && i < LIVE_STREAMS_BATCH; l = l->next, i++)
+        {
+            batch->channels = g_list_prepend(batch->channels, g_object_ref(l->data));
+            ids = g_list_prepend(ids, (gchar*) gt_channel_get_id(l->data));
+        }
+
+        gt_twitch_fetch_live_streams_async(main_app->twitch, ids,
+            priv->cancel, fetch_live_streams_cb, batch);
+
+        g_list_free(ids);
+    }
+}
+
+static void
+place_channel(GtChannelScheduler* self, GtChannel* chan, guint slot)
+{
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+
+    priv->slots[slot] = g_list_prepend(priv->slots[slot], chan);
+
+    g_hash_table_insert(priv->channels, chan, GUINT_TO_POINTER(slot));
+}
+
+static gboolean
+tick_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL_SCHEDULER(udata), G_SOURCE_REMOVE);
+
+    GtChannelScheduler* self = GT_CHANNEL_SCHEDULER(udata);
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+    GList* due = NULL;
+
+    priv->cursor = (priv->cursor + 1) % priv->n_slots;
+
+    due = priv->slots[priv->cursor];
+    priv->slots[priv->cursor] = NULL;
+
+    if (!due)
+        return G_SOURCE_CONTINUE;
+
+    //NOTE: Back on the wheel first, a turn from now give or take the jitter
+    for (GList* l = due; l != NULL; l = l->next)
+    {
+        gint offset = priv->n_slots + g_random_int_range(-JITTER_SLOTS, JITTER_SLOTS + 1);
+
+        place_channel(self, l->data, (priv->cursor + offset) % priv->n_slots);
+    }
+
+    TRACEF("Refreshing '%d' channels", g_list_length(due));
+
+    refresh_channels(self, due);
+
+    g_list_free(due);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+update_tick(GtChannelScheduler* self)
+{
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+
+    //NOTE: Don't wake up at all when there's nothing to refresh
+    if (g_hash_table_size(priv->channels) == 0 && priv->tick_id > 0)
+    {
+        g_source_remove(priv->tick_id);
+        priv->tick_id = 0;
+    }
+    else if (g_hash_table_size(priv->channels) > 0 && priv->tick_id == 0)
+        priv->tick_id = g_timeout_add_seconds(WHEEL_TICK, tick_cb, self);
+}
+
+/* NOTE: Rebuilds the wheel for a new interval, channels are spread
+ * over it again at random */
+static void
+resize_wheel(GtChannelScheduler* self)
+{
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+    gint interval = g_settings_get_int(main_app->settings, "channel-refresh-interval");
+    guint n_slots = MAX(interval / WHEEL_TICK, 2);
+    GList* chans = g_hash_table_get_keys(priv->channels);
+
+    for (guint i = 0; i < priv->n_slots; i++)
+        g_list_free(priv->slots[i]);
+
+    g_free(priv->slots);
+
+    priv->slots = g_new0(GList*, n_slots);
+    priv->n_slots = n_slots;
+    priv->cursor = 0;
+
+    for (GList* l = chans; l != NULL; l = l->next)
+        place_channel(self, l->data, g_random_int_range(0, n_slots));
+
+    g_list_free(chans);
+
+    DEBUGF("Refreshing channels every '%d' seconds over '%d' slots", interval, n_slots);
+}
+
+static void
+interval_changed_cb(GSettings* settings,
+    const gchar* key, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL_SCHEDULER(udata));
+
+    resize_wheel(GT_CHANNEL_SCHEDULER(udata));
+}
+
+static void
+finalize(GObject* obj)
+{
+    GtChannelScheduler* self = GT_CHANNEL_SCHEDULER(obj);
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+
+    g_signal_handlers_disconnect_by_func(main_app->settings, interval_changed_cb, self);
+
+    if (priv->tick_id > 0)
+        g_source_remove(priv->tick_id);
+
+    g_cancellable_cancel(priv->cancel);
+    g_clear_object(&priv->cancel);
+
+    for (guint i = 0; i < priv->n_slots; i++)
+        g_list_free(priv->slots[i]);
+
+    g_free(priv->slots);
+
+    g_hash_table_foreach(priv->channels, (GHFunc) g_object_unref, NULL);
+    g_hash_table_unref(priv->channels);
+
+    G_OBJECT_CLASS(gt_channel_scheduler_parent_class)->finalize(obj);
+}
+
+static void
+gt_channel_scheduler_class_init(GtChannelSchedulerClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = finalize;
+
+    /* NOTE: Emitted with the channels of a bulk refresh that got an
+     * answer and the ones among them that are live, both GLists of
+     * GtChannel. Not emitted when the refresh failed. */
+    sigs[SIG_CHANNELS_REFRESHED] = g_signal_new("channels-refreshed",
+        GT_TYPE_CHANNEL_SCHEDULER, G_SIGNAL_RUN_LAST, 0,
+        NULL, NULL, NULL, G_TYPE_NONE, 2, G_TYPE_POINTER, G_TYPE_POINTER);
+}
+
+static void
+gt_channel_scheduler_init(GtChannelScheduler* self)
+{
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+
+    priv->channels = g_hash_table_new(g_direct_hash, g_direct_equal);
+    priv->cancel = g_cancellable_new();
+
+    resize_wheel(self);
+
+    g_signal_connect(main_app->settings, "changed::channel-refresh-interval",
+        G_CALLBACK(interval_changed_cb), self);
+}
+
+void
+gt_channel_scheduler_add(GtChannelScheduler* self, GtChannel* chan)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL_SCHEDULER(self));
+    RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
+
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+
+    if (g_hash_table_contains(priv->channels, chan))
+        return;
+
+    //NOTE: A random slot so channels added together don't refresh together
+    place_channel(self, g_object_ref(chan), g_random_int_range(0, priv->n_slots));
+
+    update_tick(self);
+}
+
+/* NOTE: Refreshes the given channels now instead of waiting for their
+ * slot, e.g. when they were loaded from possibly stale data */
+void
+gt_channel_scheduler_refresh_now(GtChannelScheduler* self, GList* channels)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL_SCHEDULER(self));
+
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+    GList* due = NULL;
+
+    for (GList* l = channels; l != NULL; l = l->next)
+    {
+        if (g_hash_table_contains(priv->channels, l->data))
+            due = g_list_prepend(due, l->data);
+    }
+
+    if (!due)
+        return;
+
+    TRACEF("Refreshing '%d' channels ahead of schedule", g_list_length(due));
+
+    refresh_channels(self, due);
+
+    g_list_free(due);
+}
+
+void
+gt_channel_scheduler_remove(GtChannelScheduler* self, GtChannel* chan)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL_SCHEDULER(self));
+    RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
+
+    GtChannelSchedulerPrivate* priv = gt_channel_scheduler_get_instance_private(self);
+    gpointer slot;
+
+    if (!g_hash_table_lookup_extended(priv->channels, chan, NULL, &slot))
+        return;
+
+    priv->slots[GPOINTER_TO_UINT(slot)] = g_list_remove(priv->slots[GPOINTER_TO_UINT(slot)], chan);
+
+    g_hash_table_remove(priv->channels, chan);
+    g_object_unref(chan);
+
+    update_tick(self);
+}
@@ -0,0 +1,46 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_CHANNEL_SCHEDULER_H
+#define GT_CHANNEL_SCHEDULER_H
+
+#include <gtk/gtk.h>
+
+#include "gt-channel.h"
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_CHANNEL_SCHEDULER (gt_channel_scheduler_get_type())
+
+G_DECLARE_FINAL_TYPE(GtChannelScheduler, gt_channel_scheduler, GT, CHANNEL_SCHEDULER, GObject);
+
+typedef struct _GtChannelSchedulerPrivate GtChannelSchedulerPrivate;
+
+struct _GtChannelScheduler
+{
+    GObject parent_instance;
+};
+
+GtChannelScheduler* gt_channel_scheduler_new(void);
+void                gt_channel_scheduler_add(GtChannelScheduler* self, GtChannel* chan);
+void                gt_channel_scheduler_remove(GtChannelScheduler* self, GtChannel* chan);
+void                gt_channel_scheduler_refresh_now(GtChannelScheduler* self, GList* channels);
+
+G_END_DECLS
+
+#endif
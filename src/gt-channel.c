@@ -29,11 +29,20 @@
 
 #define N_JSON_PROPS 2
 
+#define PREVIEW_WIDTH 320
+#define PREVIEW_HEIGHT 180
+#define OFFLINE_PREVIEW_PATH "/com/vinszent/GnomeTwitch/icons/offline.png"
+/* NOTE: Live previews keep their url but not their content */
+#define PREVIEW_MAX_AGE (G_TIME_SPAN_MINUTE)
+
 typedef struct
 {
     GtChannelData* data;
+    gint64 data_time;
 
     GdkPixbuf* preview;
+    gchar* preview_uri;
+    gboolean preview_stale;
 
     gboolean followed;
 
@@ -44,18 +53,37 @@ typedef struct
     gchar* error_message;
     gchar* error_details;
 
-    guint update_id;
     guint update_set_id;
     guint notify_source_id;
 
+    GtResourceDownloaderPriority preview_priority;
     GCancellable* cancel;
+
+    GList* update_link; /* NOTE: Protected by update_mutex */
+
+    GtChannelChangedFlags pending_changes;
+    gboolean applying_data;
 } GtChannelPrivate;
 
+#define NUM_UPDATE_PRIORITIES (GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND + 1)
+#define MAX_UPDATE_CONCURRENCY 16
+#define MIN_UPDATE_CONCURRENCY 1.0
+#define UPDATE_LATENCY_TARGET (2*G_TIME_SPAN_SECOND)
+
 static GtResourceDownloader* preview_downloader;
 static GtResourceDownloader* banner_downloader;
 
-/* TODO: Remove the use of this, just let GLib do all the rate limiting */
+/* NOTE: Updates wait in a queue per preview priority so visible
+ * channels go first. How many run at once grows by one every window
+ * of updates that come back quickly and halves when one fails or
+ * latency climbs, like TCP's AIMD. */
 static GThreadPool* update_pool;
+static GMutex update_mutex;
+static GQueue update_queues[NUM_UPDATE_PRIORITIES];
+static gint updates_in_flight;
+static gdouble update_window;
+static gint64 update_latency;
+static gint64 update_last_decrease;
 
 G_DEFINE_TYPE_WITH_CODE(GtChannel, gt_channel, G_TYPE_INITIALLY_UNOWNED,
     G_ADD_PRIVATE(GtChannel))
@@ -85,6 +113,54 @@ enum
 
 static GParamSpec* props[NUM_PROPS];
 
+enum
+{
+    SIG_CHANGED,
+    NUM_SIGS
+};
+
+static guint sigs[NUM_SIGS];
+
+static void
+queue_change(GtChannel* self, GtChannelChangedFlags change, gint prop)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    priv->pending_changes |= change;
+
+    g_object_notify_by_pspec(G_OBJECT(self), props[prop]);
+}
+
+/* NOTE: Everything that changed during an update goes out in a single
+ * "changed" once it's done, listeners can check the mask instead of
+ * reacting to each notify */
+static void
+flush_changes(GtChannel* self)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+    GtChannelChangedFlags changes = priv->pending_changes;
+
+    if (priv->applying_data || changes == 0)
+        return;
+
+    priv->pending_changes = 0;
+
+    g_signal_emit(self, sigs[SIG_CHANGED], 0, changes);
+}
+
+static void
+set_updating(GtChannel* self, gboolean updating)
+{
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    if (priv->updating == updating)
+        return;
+
+    priv->updating = updating;
+
+    queue_change(self, GT_CHANNEL_CHANGED_UPDATING, PROP_UPDATING);
+}
+
 static void
 channel_followed_cb(GtFollowsManager* mgr,
     GtChannel* chan, gpointer udata)
@@ -125,25 +201,6 @@ channel_unfollowed_cb(GtFollowsManager* mgr,
     }
 }
 
-static gboolean
-auto_update_cb(gpointer udata)
-{
-    RETURN_VAL_IF_FAIL(udata != NULL, G_SOURCE_REMOVE);
-
-    g_autoptr(GtChannel) self = g_weak_ref_get(udata);
-
-    if (!self)
-    {
-        DEBUG("Not auto-updating because we were unreffed while wating");
-
-        return G_SOURCE_REMOVE;
-    }
-
-    gt_channel_update(self);
-
-    return G_SOURCE_CONTINUE;
-}
-
 /* TODO: Move this into set_property */
 static void
 auto_update_set_cb(GObject* src,
@@ -154,13 +211,11 @@ auto_update_set_cb(GObject* src,
     GtChannel* self = GT_CHANNEL(src);
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
+    //NOTE: The scheduler refreshes all auto-updating channels together
     if (priv->auto_update)
-    {
-        priv->update_id = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, 120, /* TODO: Add the timeout as a setting */
-            auto_update_cb, utils_create_weak_ref(self), (GDestroyNotify) utils_free_weak_ref);
-    }
+        gt_channel_scheduler_add(main_app->scheduler, self);
     else
-        g_source_remove(priv->update_id);
+        gt_channel_scheduler_remove(main_app->scheduler, self);
 }
 
 static gboolean
@@ -171,13 +226,18 @@ notify_preview_cb(gpointer udata)
     GtChannel* self = GT_CHANNEL(udata);
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW]);
+    g_object_freeze_notify(G_OBJECT(self));
 
-    priv->updating = FALSE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+    queue_change(self, GT_CHANNEL_CHANGED_PREVIEW, PROP_PREVIEW);
+
+    set_updating(self, FALSE);
 
     if (priv->error)
-        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+        queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
+
+    g_object_thaw_notify(G_OBJECT(self));
+
+    flush_changes(self);
 
     priv->notify_source_id = 0;
 
@@ -187,12 +247,33 @@ notify_preview_cb(gpointer udata)
 static void
 download_image_cb(GdkPixbuf* pixbuf, gpointer udata, GError* error)
 {
-    RETURN_IF_FAIL(GT_IS_CHANNEL(udata));
+    RETURN_IF_FAIL(udata != NULL);
+
+    g_autoptr(GtChannel) self = g_weak_ref_get(udata);
+
+    utils_free_weak_ref(udata);
+
+    if (!self)
+    {
+        TRACE("Not setting preview because we were unreffed while downloading");
+
+        g_clear_error(&error);
+        g_clear_object(&pixbuf);
+
+        return;
+    }
 
-    g_autoptr(GtChannel) self = GT_CHANNEL(udata);
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
 
-    if (error)
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        TRACE("Preview download for channel '%s' was cancelled", priv->data->name);
+
+        g_error_free(error);
+
+        return;
+    }
+    else if (error)
     {
         priv->error = TRUE;
         priv->error_message = g_strdup_printf("Unable to update preview image");
@@ -202,9 +283,12 @@ download_image_cb(GdkPixbuf* pixbuf, gpointer udata, GError* error)
     }
     else
     {
-        priv->preview = pixbuf;
+        utils_pixbuf_scale_simple(&pixbuf, PREVIEW_WIDTH, PREVIEW_HEIGHT, GDK_INTERP_BILINEAR);
+
+        gt_resource_downloader_share_image(priv->preview_uri, PREVIEW_WIDTH, PREVIEW_HEIGHT, pixbuf);
 
-        utils_pixbuf_scale_simple(&priv->preview, 320, 180, GDK_INTERP_BILINEAR);
+        g_clear_object(&priv->preview);
+        priv->preview = pixbuf;
     }
 
     if (priv->notify_source_id == 0)
@@ -214,6 +298,41 @@ download_image_cb(GdkPixbuf* pixbuf, gpointer udata, GError* error)
     }
 }
 
+static void
+download_image_progress_cb(GdkPixbuf* pixbuf, gpointer udata)
+{
+    RETURN_IF_FAIL(GDK_IS_PIXBUF(pixbuf));
+    RETURN_IF_FAIL(udata != NULL);
+
+    g_autoptr(GtChannel) self = g_weak_ref_get(udata);
+
+    if (!self)
+    {
+        g_object_unref(pixbuf);
+
+        return;
+    }
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    /* NOTE: This is only a placeholder until the full image is
+     * decoded, so go for speed over quality */
+    utils_pixbuf_scale_simple(&pixbuf, PREVIEW_WIDTH, PREVIEW_HEIGHT, GDK_INTERP_NEAREST);
+
+    g_clear_object(&priv->preview);
+    priv->preview = pixbuf;
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    queue_change(self, GT_CHANNEL_CHANGED_PREVIEW, PROP_PREVIEW);
+
+    set_updating(self, FALSE);
+
+    g_object_thaw_notify(G_OBJECT(self));
+
+    flush_changes(self);
+}
+
 static void
 update_preview(GtChannel* self)
 {
@@ -221,21 +340,62 @@ update_preview(GtChannel* self)
 
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
     g_autoptr(GError) err = NULL;
+    GdkPixbuf* preview = NULL;
+    GTimeSpan max_age = PREVIEW_MAX_AGE;
+
+    /* NOTE: A new preview supersedes any that is still being downloaded */
+    utils_refresh_cancellable(&priv->cancel);
+
+    g_free(priv->preview_uri);
 
     if (priv->data->online)
+        priv->preview_uri = g_strdup(priv->data->preview_url);
+    else if (!utils_str_empty(priv->data->video_banner_url))
+        priv->preview_uri = g_strdup(priv->data->video_banner_url);
+    else
     {
-        priv->preview = gt_resource_downloader_download_image_immediately(preview_downloader,
-            priv->data->preview_url, priv->data->id, download_image_cb, g_object_ref(self), &err);
+        priv->preview_uri = g_strdup("resource://" OFFLINE_PREVIEW_PATH);
+        max_age = -1;
     }
-    else if (!utils_str_empty(priv->data->video_banner_url))
+
+    /* NOTE: Other channels and games showing the same image may
+     * have already decoded and scaled it for us */
+    preview = gt_resource_downloader_lookup_shared_image(priv->preview_uri,
+        PREVIEW_WIDTH, PREVIEW_HEIGHT, max_age);
+
+    gboolean shared = preview != NULL;
+
+    priv->preview_stale = FALSE;
+
+    if (shared)
+        TRACE("Using shared preview for channel '%s'", priv->data->name);
+    else if (max_age >= 0 && priv->preview_priority == GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND)
     {
-        priv->preview = gt_resource_downloader_download_image_immediately(preview_downloader,
-            priv->data->video_banner_url, priv->data->id, download_image_cb, g_object_ref(self), &err);
+        /* NOTE: Nobody can see us, wait until we're scrolled into view */
+        TRACE("Deferring preview for channel '%s' until it's visible", priv->data->name);
+
+        priv->preview_stale = TRUE;
+
+        set_updating(self, FALSE);
+
+        flush_changes(self);
+
+        return;
+    }
+    else if (max_age < 0)
+        preview = gdk_pixbuf_new_from_resource(OFFLINE_PREVIEW_PATH, &err);
+    else if (priv->data->online)
+    {
+        preview = gt_resource_downloader_download_image_immediately(preview_downloader,
+            priv->preview_uri, priv->data->id, priv->preview_priority, priv->cancel,
+            download_image_cb, utils_create_weak_ref(self), &err);
     }
     else
     {
-        priv->preview = gdk_pixbuf_new_from_resource(
-            "/com/vinszent/GnomeTwitch/icons/offline.png", &err);
+        /* NOTE: Banners can be large, show them as they arrive */
+        preview = gt_resource_downloader_download_image_progressive(preview_downloader,
+            priv->preview_uri, priv->data->id, priv->preview_priority, priv->cancel,
+            download_image_progress_cb, download_image_cb, utils_create_weak_ref(self), &err);
     }
 
     if (err)
@@ -249,10 +409,21 @@ update_preview(GtChannel* self)
 
         priv->error = TRUE;
     }
-    else if (priv->preview)
+    else if (preview)
     {
-        /* FIXME: Do something about this because it can cause the UI to temporarily freeze */
-        utils_pixbuf_scale_simple(&priv->preview, 320, 180, GDK_INTERP_BILINEAR);
+        if (!shared)
+        {
+            /* FIXME: Do something about this because it can cause the UI to temporarily freeze */
+            utils_pixbuf_scale_simple(&preview, PREVIEW_WIDTH, PREVIEW_HEIGHT, GDK_INTERP_BILINEAR);
+
+            /* NOTE: Anything but the offline image came from the disk cache and
+             * may be old, only the fresh download from download_image_cb is shared */
+            if (max_age < 0)
+                gt_resource_downloader_share_image(priv->preview_uri, PREVIEW_WIDTH, PREVIEW_HEIGHT, preview);
+        }
+
+        g_clear_object(&priv->preview);
+        priv->preview = preview;
 
         notify_preview_cb(self);
     }
@@ -268,8 +439,12 @@ update_from_data(GtChannel* self, GtChannelData* data)
 
     g_autoptr(GtChannelData) old_data = priv->data;
 
-    priv->updating = TRUE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+    /* NOTE: Collect the notifies and the change mask while the new
+     * data is applied, they all go out once it's done */
+    g_object_freeze_notify(G_OBJECT(self));
+    priv->applying_data = TRUE;
+
+    set_updating(self, TRUE);
 
     priv->data = data;
 
@@ -287,9 +462,9 @@ update_from_data(GtChannel* self, GtChannelData* data)
                 old_data->id, old_data->name, data->id);
 
             priv->error = TRUE;
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+            queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
 
-            return;
+            goto finish;
         }
 
         if (!STRING_EQUALS(old_data->name, data->name))
@@ -304,35 +479,45 @@ update_from_data(GtChannel* self, GtChannelData* data)
                 old_data->id, old_data->name, data->name);
 
             priv->error = TRUE;
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+            queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
 
-            return;
+            goto finish;
         }
 
         if (!STRING_EQUALS(old_data->game, data->game))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_GAME]);
+            queue_change(self, GT_CHANNEL_CHANGED_GAME, PROP_GAME);
         if (!STRING_EQUALS(old_data->status, data->status))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_STATUS]);
+            queue_change(self, GT_CHANNEL_CHANGED_STATUS, PROP_STATUS);
         if (!STRING_EQUALS(old_data->display_name, data->display_name))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_DISPLAY_NAME]);
+            queue_change(self, GT_CHANNEL_CHANGED_DISPLAY_NAME, PROP_DISPLAY_NAME);
         if (!STRING_EQUALS(old_data->preview_url, data->preview_url))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PREVIEW_URL]);
+            queue_change(self, GT_CHANNEL_CHANGED_PREVIEW_URL, PROP_PREVIEW_URL);
         if (!STRING_EQUALS(old_data->video_banner_url, data->video_banner_url))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_VIDEO_BANNER_URL]);
+            queue_change(self, GT_CHANNEL_CHANGED_VIDEO_BANNER_URL, PROP_VIDEO_BANNER_URL);
         if (!STRING_EQUALS(old_data->logo_url, data->logo_url))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOGO_URL]);
+            queue_change(self, GT_CHANNEL_CHANGED_LOGO_URL, PROP_LOGO_URL);
         if (!STRING_EQUALS(old_data->profile_url, data->profile_url))
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_PROFILE_URL]);
+            queue_change(self, GT_CHANNEL_CHANGED_PROFILE_URL, PROP_PROFILE_URL);
         if (old_data->online != data->online)
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ONLINE]);
+            queue_change(self, GT_CHANNEL_CHANGED_ONLINE, PROP_ONLINE);
         if (old_data->viewers != data->viewers)
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_VIEWERS]);
+            queue_change(self, GT_CHANNEL_CHANGED_VIEWERS, PROP_VIEWERS);
         if (data->stream_started_time && old_data->stream_started_time &&
             g_date_time_compare(old_data->stream_started_time, data->stream_started_time) != 0)
-            g_object_notify_by_pspec(G_OBJECT(self), props[PROP_STREAM_STARTED_TIME]);
+            queue_change(self, GT_CHANNEL_CHANGED_STREAM_STARTED_TIME, PROP_STREAM_STARTED_TIME);
     }
 
+    priv->data_time = g_get_monotonic_time();
+
     update_preview(self);
+
+finish:
+    priv->applying_data = FALSE;
+    g_object_thaw_notify(G_OBJECT(self));
+
+    //NOTE: Otherwise the preview is still downloading and flushes when done
+    if (!priv->updating || priv->error)
+        flush_changes(self);
 }
 
 
@@ -361,6 +546,76 @@ update_set_cb(gpointer udata)
     return G_SOURCE_REMOVE;
 }
 
+/* NOTE: Must be called with update_mutex held */
+static void
+schedule_updates()
+{
+    for (gint i = 0; i < NUM_UPDATE_PRIORITIES; i++)
+    {
+        while (updates_in_flight < (gint) update_window && update_queues[i].head)
+        {
+            GtChannel* chan = g_queue_pop_head(&update_queues[i]);
+            GtChannelPrivate* priv = gt_channel_get_instance_private(chan);
+
+            priv->update_link = NULL;
+            updates_in_flight++;
+
+            g_thread_pool_push(update_pool, chan, NULL);
+        }
+    }
+}
+
+static void
+update_finished(gint64 latency, gboolean failed)
+{
+    gint64 now = g_get_monotonic_time();
+    gdouble old_window;
+
+    g_mutex_lock(&update_mutex);
+
+    old_window = update_window;
+
+    update_latency = update_latency == 0 ? latency : (update_latency*7 + latency) / 8;
+
+    //NOTE: Only back off once per round trip, one slow batch shouldn't
+    //collapse the window all the way down
+    if ((failed || update_latency > UPDATE_LATENCY_TARGET) &&
+        now - update_last_decrease > update_latency)
+    {
+        update_window = MAX(update_window / 2, MIN_UPDATE_CONCURRENCY);
+        update_last_decrease = now;
+    }
+    else if (!failed && update_latency <= UPDATE_LATENCY_TARGET)
+        update_window = MIN(update_window + 1 / update_window, MAX_UPDATE_CONCURRENCY);
+
+    if ((gint) update_window != (gint) old_window)
+    {
+        DEBUGF("Channel update concurrency now '%d' with latency '%" G_GINT64_FORMAT "ms'",
+            (gint) update_window, update_latency / 1000);
+    }
+
+    updates_in_flight--;
+
+    schedule_updates();
+
+    g_mutex_unlock(&update_mutex);
+}
+
+//NOTE: Signals are only emitted from the main thread
+static gboolean
+update_error_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(udata), G_SOURCE_REMOVE);
+
+    GtChannel* self = GT_CHANNEL(udata);
+
+    queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
+
+    flush_changes(self);
+
+    return G_SOURCE_REMOVE;
+}
+
 static void
 update_cb(gpointer data,
     gpointer udata)
@@ -370,10 +625,13 @@ update_cb(gpointer data,
     g_autoptr(GtChannel) self = data;
     GtChannelPrivate* priv = gt_channel_get_instance_private(self);
     g_autoptr(GError) err = NULL;
+    gint64 start = g_get_monotonic_time();
 
     GtChannelData* chan_data = gt_twitch_fetch_channel_data(
         main_app->twitch, priv->data->id, &err);
 
+    update_finished(g_get_monotonic_time() - start, err != NULL);
+
     if (err)
     {
         WARNING("Unable to fetch channel data because: %s", err->message);
@@ -384,7 +642,9 @@ update_cb(gpointer data,
             priv->data->name, err->message);
 
         priv->error = TRUE;
-        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, update_error_cb,
+            g_object_ref(self), g_object_unref);
 
         return;
     }
@@ -417,8 +677,7 @@ finalize(GObject* object)
 
     gt_channel_data_free(priv->data);
 
-    if (priv->update_id > 0)
-        g_source_remove(priv->update_id);
+    g_free(priv->preview_uri);
 
     if (priv->notify_source_id > 0)
         g_source_remove(priv->notify_source_id);
@@ -530,6 +789,10 @@ gt_channel_class_init(GtChannelClass* klass)
     object_class->get_property = get_property;
     object_class->set_property = set_property;
 
+    sigs[SIG_CHANGED] = g_signal_new("changed",
+        GT_TYPE_CHANNEL, G_SIGNAL_RUN_LAST, 0,
+        NULL, NULL, NULL, G_TYPE_NONE, 1, G_TYPE_UINT);
+
     props[PROP_ID] = g_param_spec_string("id", "ID", "ID of channel",
         NULL, G_PARAM_READABLE);
 
@@ -595,7 +858,11 @@ gt_channel_class_init(GtChannelClass* klass)
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), preview_downloader);
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), banner_downloader);
 
-    update_pool = g_thread_pool_new((GFunc) update_cb, NULL, 2, FALSE, NULL);
+    for (gint i = 0; i < NUM_UPDATE_PRIORITIES; i++)
+        g_queue_init(&update_queues[i]);
+
+    update_window = 2.0;
+    update_pool = g_thread_pool_new((GFunc) update_cb, NULL, MAX_UPDATE_CONCURRENCY, FALSE, NULL);
 }
 
 
@@ -608,9 +875,9 @@ gt_channel_init(GtChannel* self)
 
     priv->data = NULL;
     priv->updating = FALSE;
+    priv->preview_priority = GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND;
     priv->cancel = g_cancellable_new();
 
-    priv->update_id = 0;
     priv->update_set_id = 0;
 
     priv->error_message = NULL;
@@ -638,6 +905,22 @@ gt_channel_new(GtChannelData* data)
     return channel;
 }
 
+/* NOTE: For data saved earlier, it is only as fresh as age says so
+ * the scheduler knows when it needs revalidating */
+GtChannel*
+gt_channel_new_from_snapshot(GtChannelData* data, GTimeSpan age)
+{
+    RETURN_VAL_IF_FAIL(data != NULL, NULL);
+
+    GtChannel* channel = gt_channel_new(data);
+    GtChannelPrivate* priv = gt_channel_get_instance_private(channel);
+    gint64 now = g_get_monotonic_time();
+
+    priv->data_time = age >= 0 && age < now ? now - age : 0;
+
+    return channel;
+}
+
 GtChannel*
 gt_channel_new_from_id_and_name(const gchar* id, const gchar* name)
 {
@@ -774,6 +1057,47 @@ gt_channel_is_followed(GtChannel* self)
     return priv->followed;
 }
 
+/* NOTE: For when the data was fetched elsewhere, e.g. in bulk */
+void
+gt_channel_update_from_data(GtChannel* self, GtChannelData* data)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL(self));
+    RETURN_IF_FAIL(data != NULL);
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    g_clear_pointer(&priv->error_message, g_free);
+    g_clear_pointer(&priv->error_details, g_free);
+
+    if (priv->error)
+    {
+        priv->error = FALSE;
+        queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
+    }
+
+    update_from_data(self, data);
+}
+
+GtChannelData*
+gt_channel_dup_data(GtChannel* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(self), NULL);
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    return priv->data ? gt_channel_data_copy(priv->data) : NULL;
+}
+
+GTimeSpan
+gt_channel_get_data_age(GtChannel* self)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(self), G_MAXINT64);
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    return priv->data_time > 0 ? g_get_monotonic_time() - priv->data_time : G_MAXINT64;
+}
+
 gboolean
 gt_channel_update(GtChannel* self)
 {
@@ -787,17 +1111,86 @@ gt_channel_update(GtChannel* self)
     g_clear_pointer(&priv->error_message, g_free);
     g_clear_pointer(&priv->error_details, g_free);
 
-    priv->error = FALSE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_ERROR]);
+    g_object_freeze_notify(G_OBJECT(self));
 
-    priv->updating = TRUE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_UPDATING]);
+    if (priv->error)
+    {
+        priv->error = FALSE;
+        queue_change(self, GT_CHANNEL_CHANGED_ERROR, PROP_ERROR);
+    }
+
+    set_updating(self, TRUE);
+
+    g_object_thaw_notify(G_OBJECT(self));
+
+    g_mutex_lock(&update_mutex);
+
+    //NOTE: Already waiting its turn, no need to fetch it twice
+    if (!priv->update_link)
+    {
+        g_queue_push_tail(&update_queues[priv->preview_priority], g_object_ref(self));
+        priv->update_link = update_queues[priv->preview_priority].tail;
+
+        schedule_updates();
+    }
 
-    g_thread_pool_push(update_pool, g_object_ref(self), NULL);
+    g_mutex_unlock(&update_mutex);
 
     return TRUE;
 }
 
+void
+gt_channel_get_update_counts(guint* in_flight, guint* queued)
+{
+    g_mutex_lock(&update_mutex);
+
+    if (in_flight)
+        *in_flight = updates_in_flight;
+
+    if (queued)
+    {
+        *queued = 0;
+
+        for (gint i = 0; i < NUM_UPDATE_PRIORITIES; i++)
+            *queued += update_queues[i].length;
+    }
+
+    g_mutex_unlock(&update_mutex);
+}
+
+void
+gt_channel_set_preview_priority(GtChannel* self, GtResourceDownloaderPriority priority)
+{
+    RETURN_IF_FAIL(GT_IS_CHANNEL(self));
+
+    GtChannelPrivate* priv = gt_channel_get_instance_private(self);
+
+    if (priv->preview_priority == priority)
+        return;
+
+    //NOTE: Move a waiting update along with the preview
+    g_mutex_lock(&update_mutex);
+
+    if (priv->update_link)
+    {
+        g_queue_unlink(&update_queues[priv->preview_priority], priv->update_link);
+        g_queue_push_tail_link(&update_queues[priority], priv->update_link);
+    }
+
+    priv->preview_priority = priority;
+
+    g_mutex_unlock(&update_mutex);
+
+    if (priv->preview_stale && priority != GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND)
+    {
+        set_updating(self, TRUE);
+
+        update_preview(self);
+    }
+    else
+        gt_resource_downloader_set_priority(preview_downloader, priv->cancel, priority);
+}
+
 const gchar*
 gt_channel_get_error_message(GtChannel* self)
 {
@@ -824,6 +1217,30 @@ gt_channel_data_new()
     return g_slice_new0(GtChannelData);
 }
 
+GtChannelData*
+gt_channel_data_copy(GtChannelData* data)
+{
+    RETURN_VAL_IF_FAIL(data != NULL, NULL);
+
+    GtChannelData* ret = gt_channel_data_new();
+
+    ret->id = g_strdup(data->id);
+    ret->game = g_strdup(data->game);
+    ret->viewers = data->viewers;
+    ret->stream_started_time = data->stream_started_time ?
+        g_date_time_ref(data->stream_started_time) : NULL;
+    ret->status = g_strdup(data->status);
+    ret->name = g_strdup(data->name);
+    ret->display_name = g_strdup(data->display_name);
+    ret->preview_url = g_strdup(data->preview_url);
+    ret->video_banner_url = g_strdup(data->video_banner_url);
+    ret->logo_url = g_strdup(data->logo_url);
+    ret->profile_url = g_strdup(data->profile_url);
+    ret->online = data->online;
+
+    return ret;
+}
+
 void
 gt_channel_data_free(GtChannelData* data)
 {
@@ -836,6 +1253,8 @@ gt_channel_data_free(GtChannelData* data)
     g_free(data->display_name);
     g_free(data->preview_url);
     g_free(data->video_banner_url);
+    g_free(data->logo_url);
+    g_free(data->profile_url);
     if (data->stream_started_time)
         g_date_time_unref(data->stream_started_time);
     g_slice_free(GtChannelData, data);
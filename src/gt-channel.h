@@ -20,6 +20,7 @@
 #define GT_CHANNEL_H
 
 #include <gtk/gtk.h>
+#include "gt-resource-downloader.h"
 
 G_BEGIN_DECLS
 
@@ -32,6 +33,24 @@ struct _GtChannel
     GInitiallyUnowned parent_instance;
 };
 
+//NOTE: Mask of what changed, passed along with the "changed" signal
+typedef enum
+{
+    GT_CHANNEL_CHANGED_STATUS              = 1 << 0,
+    GT_CHANNEL_CHANGED_GAME                = 1 << 1,
+    GT_CHANNEL_CHANGED_DISPLAY_NAME        = 1 << 2,
+    GT_CHANNEL_CHANGED_PREVIEW_URL         = 1 << 3,
+    GT_CHANNEL_CHANGED_VIDEO_BANNER_URL    = 1 << 4,
+    GT_CHANNEL_CHANGED_LOGO_URL            = 1 << 5,
+    GT_CHANNEL_CHANGED_PROFILE_URL         = 1 << 6,
+    GT_CHANNEL_CHANGED_ONLINE              = 1 << 7,
+    GT_CHANNEL_CHANGED_VIEWERS             = 1 << 8,
+    GT_CHANNEL_CHANGED_STREAM_STARTED_TIME = 1 << 9,
+    GT_CHANNEL_CHANGED_PREVIEW             = 1 << 10,
+    GT_CHANNEL_CHANGED_UPDATING            = 1 << 11,
+    GT_CHANNEL_CHANGED_ERROR               = 1 << 12,
+} GtChannelChangedFlags;
+
 typedef struct
 {
     gchar* id;
@@ -50,6 +69,7 @@ typedef struct
 
 GtChannel*     gt_channel_new(GtChannelData* data);
 GtChannel*     gt_channel_new_from_id_and_name(const gchar* id, const gchar* name);
+GtChannel*     gt_channel_new_from_snapshot(GtChannelData* data, GTimeSpan age);
 void           gt_channel_toggle_followed(GtChannel* self);
 void           gt_channel_list_free(GList* list);
 gboolean       gt_channel_compare(GtChannel* self, gpointer other);
@@ -64,7 +84,13 @@ gboolean       gt_channel_is_followed(GtChannel* self);
 const gchar*   gt_channel_get_error_message(GtChannel* self);
 const gchar*   gt_channel_get_error_details(GtChannel* self);
 gboolean       gt_channel_update(GtChannel* self);
+void           gt_channel_update_from_data(GtChannel* self, GtChannelData* data);
+GtChannelData* gt_channel_dup_data(GtChannel* self);
+GTimeSpan      gt_channel_get_data_age(GtChannel* self);
+void           gt_channel_get_update_counts(guint* in_flight, guint* queued);
+void           gt_channel_set_preview_priority(GtChannel* self, GtResourceDownloaderPriority priority);
 GtChannelData* gt_channel_data_new();
+GtChannelData* gt_channel_data_copy(GtChannelData* data);
 void           gt_channel_data_free(GtChannelData* data);
 void           gt_channel_data_list_free(GList* list);
 gint           gt_channel_data_compare(GtChannelData* a, GtChannelData* b);
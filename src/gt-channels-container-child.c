@@ -24,6 +24,8 @@
 #define TAG "GtChannelsContainerChild"
 #include "utils.h"
 
+#define PREFETCH_DELAY 300 /* NOTE: In milliseconds */
+
 typedef struct
 {
     GtkWidget* preview_image;
@@ -43,6 +45,10 @@ typedef struct
     GtkWidget* error_reload_button;
     GtkWidget* error_link_button;
     GtkWidget* updating_spinner;
+
+    GPtrArray* bindings;
+
+    guint prefetch_source;
 } GtChannelsContainerChildPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtChannelsContainerChild, gt_channels_container_child, GTK_TYPE_FLOW_BOX_CHILD)
@@ -64,6 +70,43 @@ gt_channels_container_child_new(GtChannel* chan)
                         NULL);
 }
 
+static gboolean
+prefetch_cb(gpointer udata)
+{
+    GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(udata);
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    priv->prefetch_source = 0;
+
+    if (gt_channel_is_online(self->channel))
+        gt_twitch_prefetch_streams(main_app->twitch, gt_channel_get_name(self->channel));
+
+    return G_SOURCE_REMOVE;
+}
+
+//NOTE: Only prefetch once the pointer or focus has rested here a moment,
+//sweeping across the grid shouldn't fetch every channel on the way
+static void
+schedule_prefetch(GtChannelsContainerChild* self)
+{
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    if (priv->prefetch_source == 0)
+        priv->prefetch_source = g_timeout_add(PREFETCH_DELAY, prefetch_cb, self);
+}
+
+static void
+cancel_prefetch(GtChannelsContainerChild* self)
+{
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    if (priv->prefetch_source > 0)
+    {
+        g_source_remove(priv->prefetch_source);
+        priv->prefetch_source = 0;
+    }
+}
+
 static void
 motion_enter_cb(GtkWidget* widget,
                 GdkEvent* evt,
@@ -73,6 +116,8 @@ motion_enter_cb(GtkWidget* widget,
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
     gtk_revealer_set_reveal_child(GTK_REVEALER(priv->preview_overlay_revealer), TRUE);
+
+    schedule_prefetch(self);
 }
 
 static void
@@ -84,6 +129,26 @@ motion_leave_cb(GtkWidget* widget,
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
     gtk_revealer_set_reveal_child(GTK_REVEALER(priv->preview_overlay_revealer), FALSE);
+
+    cancel_prefetch(self);
+}
+
+static gboolean
+focus_in_cb(GtkWidget* widget,
+    GdkEvent* evt, gpointer udata)
+{
+    schedule_prefetch(GT_CHANNELS_CONTAINER_CHILD(widget));
+
+    return GDK_EVENT_PROPAGATE;
+}
+
+static gboolean
+focus_out_cb(GtkWidget* widget,
+    GdkEvent* evt, gpointer udata)
+{
+    cancel_prefetch(GT_CHANNELS_CONTAINER_CHILD(widget));
+
+    return GDK_EVENT_PROPAGATE;
 }
 
 static void
@@ -212,12 +277,107 @@ state_changed_cb(GtChannelsContainerChild* self)
         gtk_stack_set_visible_child(GTK_STACK(priv->preview_stack), priv->preview_box);
 }
 
+static void
+channel_changed_cb(GtChannel* chan,
+    GtChannelChangedFlags changes, gpointer udata)
+{
+    GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(udata);
+
+    if (changes & GT_CHANNEL_CHANGED_ONLINE)
+        online_cb(self);
+
+    if (changes & (GT_CHANNEL_CHANGED_UPDATING | GT_CHANNEL_CHANGED_ERROR))
+        state_changed_cb(self);
+}
+
+static void
+error_reload_cb(GtkButton* button,
+    gpointer udata)
+{
+    g_assert(GT_IS_CHANNELS_CONTAINER_CHILD(udata));
+
+    GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(udata);
+
+    gt_channel_update(self->channel);
+}
+
+static void
+bind_channel(GtChannelsContainerChild* self)
+{
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "display-name",
+            priv->name_label, "label",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "game",
+            priv->game_label, "label",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "followed",
+            priv->follow_button, "active",
+            G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "preview",
+            priv->preview_image, "pixbuf",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property_full(self->channel, "viewers",
+            priv->viewers_label, "label",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
+            (GBindingTransformFunc) viewers_converter,
+            NULL, NULL, NULL));
+    g_ptr_array_add(priv->bindings, g_object_bind_property_full(self->channel, "stream-started-time",
+            priv->time_label, "label",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
+            (GBindingTransformFunc) time_converter,
+            NULL, NULL, NULL));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->viewers_label, "visible",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->viewers_image, "visible",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->time_label, "visible",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->time_image, "visible",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+    g_ptr_array_add(priv->bindings, g_object_bind_property(self->channel, "online",
+            priv->play_image, "visible",
+            G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+    g_signal_connect_object(self->channel, "changed", G_CALLBACK(channel_changed_cb), self, 0);
+
+    state_changed_cb(self);
+    online_cb(self);
+}
+
+static void
+unbind_channel(GtChannelsContainerChild* self)
+{
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    if (!self->channel)
+        return;
+
+    for (guint i = 0; i < priv->bindings->len; i++)
+        g_binding_unbind(g_ptr_array_index(priv->bindings, i));
+
+    g_ptr_array_set_size(priv->bindings, 0);
+
+    g_signal_handlers_disconnect_by_func(self->channel, channel_changed_cb, self);
+}
+
 static void
 dispose(GObject* object)
 {
     GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(object);
+    GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
+
+    cancel_prefetch(self);
+
+    unbind_channel(self);
 
     g_clear_object(&self->channel);
+    g_clear_pointer(&priv->bindings, g_ptr_array_unref);
 
     G_OBJECT_CLASS(gt_channels_container_child_parent_class)->dispose(object);
 }
@@ -267,51 +427,7 @@ constructed(GObject* obj)
     GtChannelsContainerChild* self = GT_CHANNELS_CONTAINER_CHILD(obj);
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
-    g_object_bind_property(self->channel, "display-name",
-                           priv->name_label, "label",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "game",
-                           priv->game_label, "label",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "followed",
-                           priv->follow_button, "active",
-                           G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "preview",
-                           priv->preview_image, "pixbuf",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property_full(self->channel, "viewers",
-                                priv->viewers_label, "label",
-                                G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
-                                (GBindingTransformFunc) viewers_converter,
-                                NULL, NULL, NULL);
-    g_object_bind_property_full(self->channel, "stream-started-time",
-                                priv->time_label, "label",
-                                G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
-                                (GBindingTransformFunc) time_converter,
-                                NULL, NULL, NULL);
-    g_object_bind_property(self->channel, "online",
-                           priv->viewers_label, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->viewers_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->time_label, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->time_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-    g_object_bind_property(self->channel, "online",
-                           priv->play_image, "visible",
-                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-    g_signal_connect_object(self->channel, "notify::online", G_CALLBACK(online_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_object(self->channel, "notify::error", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_object(self->channel, "notify::updating", G_CALLBACK(state_changed_cb), self, G_CONNECT_SWAPPED);
-    g_signal_connect_swapped(priv->error_reload_button, "clicked", G_CALLBACK(gt_channel_update), self->channel);
-
-    state_changed_cb(self);
-    online_cb(self);
+    bind_channel(self);
 
     G_OBJECT_CLASS(gt_channels_container_child_parent_class)->constructed(obj);
 }
@@ -361,9 +477,14 @@ gt_channels_container_child_init(GtChannelsContainerChild* self)
 {
     GtChannelsContainerChildPrivate* priv = gt_channels_container_child_get_instance_private(self);
 
+    priv->bindings = g_ptr_array_new();
+
     gtk_widget_init_template(GTK_WIDGET(self));
 
+    g_signal_connect(priv->error_reload_button, "clicked", G_CALLBACK(error_reload_cb), self);
     g_signal_connect(priv->error_link_button, "clicked", G_CALLBACK(error_link_clicked_cb), self);
+    g_signal_connect(self, "focus-in-event", G_CALLBACK(focus_in_cb), NULL);
+    g_signal_connect(self, "focus-out-event", G_CALLBACK(focus_out_cb), NULL);
 }
 
 void
@@ -373,3 +494,35 @@ gt_channels_container_child_hide_overlay(GtChannelsContainerChild* self)
 
     gtk_revealer_set_reveal_child(GTK_REVEALER(priv->preview_overlay_revealer), FALSE);
 }
+
+/* NOTE: Lets a recycled child show a different channel without rebuilding its widgets */
+void
+gt_channels_container_child_set_channel(GtChannelsContainerChild* self, GtChannel* chan)
+{
+    g_assert(GT_IS_CHANNELS_CONTAINER_CHILD(self));
+    g_assert(GT_IS_CHANNEL(chan));
+
+    if (self->channel == chan)
+        return;
+
+    cancel_prefetch(self);
+    unbind_channel(self);
+
+    g_clear_object(&self->channel);
+    self->channel = g_object_ref_sink(chan);
+
+    bind_channel(self);
+
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_CHANNEL]);
+}
+
+//NOTE: Shared bind_child for the containers that show channels in these children
+void
+gt_channels_container_child_bind(GtItemContainer* item_container,
+    GtkWidget* child, gpointer item)
+{
+    g_assert(GT_IS_ITEM_CONTAINER(item_container));
+    g_assert(GT_IS_CHANNEL(item));
+
+    gt_channels_container_child_set_channel(GT_CHANNELS_CONTAINER_CHILD(child), GT_CHANNEL(item));
+}
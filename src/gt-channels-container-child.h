@@ -21,6 +21,7 @@
 
 #include <gtk/gtk.h>
 #include "gt-channel.h"
+#include "gt-item-container.h"
 
 G_BEGIN_DECLS
 
@@ -37,6 +38,8 @@ struct _GtChannelsContainerChild
 
 GtChannelsContainerChild* gt_channels_container_child_new(GtChannel* chan);
 void gt_channels_container_child_hide_overlay(GtChannelsContainerChild* self);
+void gt_channels_container_child_set_channel(GtChannelsContainerChild* self, GtChannel* chan);
+void gt_channels_container_child_bind(GtItemContainer* item_container, GtkWidget* child, gpointer item);
 
 G_END_DECLS
 
@@ -37,6 +37,12 @@ typedef struct
     GtkWidget* item_flow;
     GMutex mutex;
     GCond cond;
+
+    /* NOTE: Children whose channel changed since the last frame, they
+     * are moved to their new positions in one go on the next one */
+    GHashTable* children;
+    GHashTable* resort_pending;
+    guint resort_tick_id;
 } GtFollowedChannelContainerPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtFollowedChannelContainer, gt_followed_channel_container, GT_TYPE_ITEM_CONTAINER);
@@ -66,19 +72,59 @@ get_properties(GtItemContainer* self,
     *fetching_label_text = g_strdup(_("Fetching channels"));
 }
 
+static gboolean
+resort_tick_cb(GtkWidget* widget,
+    GdkFrameClock* clock, gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(udata), G_SOURCE_REMOVE);
+
+    GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
+    GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
+    GHashTableIter iter;
+    gpointer child;
+
+    TRACEF("Moving '%d' changed children", g_hash_table_size(priv->resort_pending));
+
+    //NOTE: Each child is found its new place by binary search instead of
+    //sorting the whole flow box again
+    g_hash_table_iter_init(&iter, priv->resort_pending);
+    while (g_hash_table_iter_next(&iter, &child, NULL))
+        gtk_flow_box_child_changed(GTK_FLOW_BOX_CHILD(child));
+
+    g_hash_table_remove_all(priv->resort_pending);
+
+    priv->resort_tick_id = 0;
+
+    return G_SOURCE_REMOVE;
+}
+
 static void
-channel_updating_cb(GObject* source,
-    GParamSpec* pspec, gpointer udata)
+channel_changed_cb(GtChannel* chan,
+    GtChannelChangedFlags changes, gpointer udata)
 {
     RETURN_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(udata));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(source));
+    RETURN_IF_FAIL(GT_IS_CHANNEL(chan));
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
+    GtkWidget* child = NULL;
 
-    if (!gt_channel_is_updating(GT_CHANNEL(source)))
-        gtk_flow_box_invalidate_sort(GTK_FLOW_BOX(priv->item_flow));
+    //NOTE: Channels are sorted by whether they're online and their name,
+    //only a change in the former can move them
+    if (!(changes & GT_CHANNEL_CHANGED_ONLINE))
+        return;
 
+    child = g_hash_table_lookup(priv->children, chan);
+
+    RETURN_IF_FAIL(child != NULL);
+
+    g_hash_table_add(priv->resort_pending, child);
+
+    if (priv->resort_tick_id == 0)
+    {
+        priv->resort_tick_id = gtk_widget_add_tick_callback(priv->item_flow,
+            resort_tick_cb, self, NULL);
+    }
 }
 
 static GtkWidget*
@@ -88,11 +134,15 @@ create_child(GtItemContainer* item_container, gpointer data)
     RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(data), NULL);
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(item_container);
+    GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
+    GtkWidget* child = GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
+
+    g_hash_table_insert(priv->children, data, child);
 
-    g_signal_connect_object(data, "notify::updating",
-        G_CALLBACK(channel_updating_cb), self, 0);
+    g_signal_connect_object(data, "changed",
+        G_CALLBACK(channel_changed_cb), self, 0);
 
-    return GTK_WIDGET(gt_channels_container_child_new(GT_CHANNEL(data)));
+    return child;
 }
 
 static void
@@ -139,6 +189,7 @@ on_clear(GtItemContainer* item_container,
     RETURN_IF_FAIL(GT_IS_FOLLOWED_CHANNEL_CONTAINER(item_container));
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(item_container);
+    GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
     for (GList* l = items; l != NULL; l = l->next)
     {
@@ -146,7 +197,21 @@ on_clear(GtItemContainer* item_container,
 
         GtChannel* chan = l->data;
 
-        g_signal_handlers_disconnect_by_func(chan, channel_updating_cb, self);
+        g_signal_handlers_disconnect_by_func(chan, channel_changed_cb, self);
+
+        GtkWidget* child = g_hash_table_lookup(priv->children, chan);
+
+        if (child)
+            g_hash_table_remove(priv->resort_pending, child);
+
+        g_hash_table_remove(priv->children, chan);
+    }
+
+    //NOTE: Also called for single unfollowed channels, keep the tick for the rest
+    if (priv->resort_tick_id > 0 && g_hash_table_size(priv->resort_pending) == 0)
+    {
+        gtk_widget_remove_tick_callback(priv->item_flow, priv->resort_tick_id);
+        priv->resort_tick_id = 0;
     }
 }
 
@@ -160,9 +225,7 @@ channel_followed_cb(GtFollowsManager* mgr,
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
 
-    //TODO: Ideally we should just add the channel instead of refreshing
-    // the entire container.
-    gt_item_container_refresh(GT_ITEM_CONTAINER(self));
+    gt_item_container_append_item(GT_ITEM_CONTAINER(self), chan);
 }
 
 static void
@@ -175,7 +238,7 @@ channel_unfollowed_cb(GtFollowsManager* mgr,
 
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
 
-    gt_item_container_refresh(GT_ITEM_CONTAINER(self));
+    gt_item_container_remove_item(GT_ITEM_CONTAINER(self), chan);
 }
 
 static void
@@ -236,27 +299,17 @@ sort_by_name_and_online(GtkFlowBoxChild* _child1,
     GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(udata);
     GtChannelsContainerChild* child1 = GT_CHANNELS_CONTAINER_CHILD(_child1);
     GtChannelsContainerChild* child2 = GT_CHANNELS_CONTAINER_CHILD(_child2);
-    gboolean online1;
-    gboolean online2;
-    g_autofree gchar* name1;
-    g_autofree gchar* name2;
+    //NOTE: Called a lot when sorting, don't copy anything here
+    gboolean online1 = gt_channel_is_online(child1->channel);
+    gboolean online2 = gt_channel_is_online(child2->channel);
     gint ret = 0;
 
-    g_object_get(child1->channel,
-                 "online", &online1,
-                 "name", &name1,
-                 NULL);
-    g_object_get(child2->channel,
-                 "online", &online2,
-                 "name", &name2,
-                 NULL);
-
     if(online1 && !online2)
         ret = -1;
     else if (!online1 && online2)
         ret = 1;
     else
-        ret = g_strcmp0(name1, name2);
+        ret = g_strcmp0(gt_channel_get_name(child1->channel), gt_channel_get_name(child2->channel));
 
     return ret;
 }
@@ -315,7 +368,6 @@ constructed(GObject* obj)
     gtk_flow_box_set_sort_func(GTK_FLOW_BOX(priv->item_flow),
         (GtkFlowBoxSortFunc) sort_by_name_and_online, self, NULL);
 
-    //TODO: Need to refresh everytime a channel is followed or unfollowed
     g_signal_connect(main_app->fav_mgr, "notify::loading-follows", G_CALLBACK(finished_loading_follows_cb), self);
     g_signal_connect(main_app->fav_mgr, "channel-followed", G_CALLBACK(channel_followed_cb), self);
     g_signal_connect(main_app->fav_mgr, "channel-unfollowed", G_CALLBACK(channel_unfollowed_cb), self);
@@ -325,9 +377,22 @@ constructed(GObject* obj)
     G_OBJECT_CLASS(gt_followed_channel_container_parent_class)->constructed(obj);
 }
 
+static void
+finalize(GObject* obj)
+{
+    GtFollowedChannelContainer* self = GT_FOLLOWED_CHANNEL_CONTAINER(obj);
+    GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
+
+    g_hash_table_unref(priv->children);
+    g_hash_table_unref(priv->resort_pending);
+
+    G_OBJECT_CLASS(gt_followed_channel_container_parent_class)->finalize(obj);
+}
+
 static void
 gt_followed_channel_container_class_init(GtFollowedChannelContainerClass* klass)
 {
+    G_OBJECT_CLASS(klass)->finalize = finalize;
     G_OBJECT_CLASS(klass)->constructed = constructed;
     G_OBJECT_CLASS(klass)->get_property = get_property;
     G_OBJECT_CLASS(klass)->set_property = set_property;
@@ -349,6 +414,8 @@ gt_followed_channel_container_init(GtFollowedChannelContainer* self)
     GtFollowedChannelContainerPrivate* priv = gt_followed_channel_container_get_instance_private(self);
 
     priv->item_flow = gt_item_container_get_flow_box(GT_ITEM_CONTAINER(self));
+    priv->children = g_hash_table_new(g_direct_hash, g_direct_equal);
+    priv->resort_pending = g_hash_table_new(g_direct_hash, g_direct_equal);
 
     g_mutex_init(&priv->mutex);
 }
@@ -19,6 +19,7 @@
 #include "gt-follows-manager.h"
 #include "gt-app.h"
 #include "gt-win.h"
+#include "gt-persistent-file.h"
 #include "utils.h"
 #include <json-glib/json-glib.h>
 #include <glib/gprintf.h>
@@ -32,13 +33,51 @@
 #define FAV_CHANNELS_FILE g_build_filename(g_get_user_data_dir(), "gnome-twitch", "followed-channels.json", NULL);
 
 #define FOLLOWED_CHANNELS_FILE_VERSION 1
+#define FOLLOWED_CHANNELS_FLUSH_TIMEOUT (G_TIME_SPAN_SECOND*2)
 
+/* NOTE: Last known data of the follows so they can be shown straight
+ * away at startup, it's only a cache so it lives with the others */
+#define SNAPSHOT_FILE g_build_filename(g_get_user_cache_dir(), "gnome-twitch", "followed-channels-snapshot.json", NULL)
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_INTERVAL (5*60) /* NOTE: In seconds */
+
+#define MOVE_FOLLOWS_CONCURRENCY 4
+
+#define LIVE_NOTIFICATION_MAX_NAMES 3
+
+/* NOTE: follow_channels keeps the order, the index finds a channel's
+ * link by id so checks and removals don't walk the list */
 struct _GtFollowsManagerPrivate
 {
     gboolean loading_follows;
     GCancellable* cancel;
+    guint snapshot_id;
+
+    GHashTable* follow_index; /* NOTE: Channel id to its link in follow_channels */
+    GList* follow_tail;
+
+    GtPersistentFile* follows_file; /* NOTE: Only kept up to date with local follows */
+    GtPersistentFile* snapshot_file;
+
+    GHashTable* live_states; /* NOTE: Channel id to whether it was live when last refreshed */
 };
 
+typedef struct
+{
+    GtFollowsManager* self;
+    JsonNode* follows;
+} LoadFollowsData;
+
+typedef struct
+{
+    GtFollowsManager* self;
+    GList* channels;
+    GList* next; /* NOTE: Next link in channels to follow */
+    guint in_flight;
+    guint failed;
+    gchar* error_message;
+} MoveFollowsData;
+
 G_DEFINE_TYPE_WITH_PRIVATE(GtFollowsManager, gt_follows_manager, G_TYPE_OBJECT)
 
 enum
@@ -67,33 +106,178 @@ gt_follows_manager_new(void)
 }
 
 static void
-channel_online_cb(GObject* source,
-    GParamSpec* pspec, gpointer udata)
+index_follows(GtFollowsManager* self)
 {
-    RETURN_IF_FAIL(GT_IS_CHANNEL(source));
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
 
-    GtChannel* chan = GT_CHANNEL(source);
+    g_hash_table_remove_all(priv->follow_index);
+    priv->follow_tail = NULL;
+
+    for (GList* l = self->follow_channels; l != NULL; l = l->next)
+    {
+        g_hash_table_replace(priv->follow_index, g_strdup(gt_channel_get_id(l->data)), l);
+        priv->follow_tail = l;
+    }
+}
+
+static void
+add_follow(GtFollowsManager* self, GtChannel* chan)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GList* link = g_list_alloc();
+
+    link->data = chan;
+    link->prev = priv->follow_tail;
+
+    if (priv->follow_tail)
+        priv->follow_tail->next = link;
+    else
+        self->follow_channels = link;
+
+    priv->follow_tail = link;
+
+    g_hash_table_replace(priv->follow_index, g_strdup(gt_channel_get_id(chan)), link);
+}
+
+//NOTE: Returns the unlinked link, its channel is still reffed
+static GList*
+remove_follow(GtFollowsManager* self, const gchar* id)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GList* link = g_hash_table_lookup(priv->follow_index, id);
+
+    if (!link)
+        return NULL;
+
+    if (link == priv->follow_tail)
+        priv->follow_tail = link->prev;
+
+    self->follow_channels = g_list_remove_link(self->follow_channels, link);
+
+    g_hash_table_remove(priv->follow_index, id);
+
+    return link;
+}
+
+static void
+store_local_follow(GtFollowsManager* self, GtChannel* chan)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    g_autoptr(JsonBuilder) builder = json_builder_new();
+    g_autoptr(JsonNode) node = NULL;
+
+    json_builder_begin_object(builder);
+
+    json_builder_set_member_name(builder, "id");
+    json_builder_add_string_value(builder, gt_channel_get_id(chan));
 
-    if (gt_channel_is_online(chan) && gt_app_should_show_notifications(main_app))
+    json_builder_set_member_name(builder, "name");
+    json_builder_add_string_value(builder, gt_channel_get_name(chan));
+
+    json_builder_end_object(builder);
+
+    node = json_builder_get_root(builder);
+
+    gt_persistent_file_set_node(priv->follows_file, gt_channel_get_id(chan), node);
+}
+
+static void
+notify_went_live(GtFollowsManager* self, GList* channels)
+{
+    g_autoptr(GNotification) notification = NULL;
+    g_autofree gchar* title_str = NULL;
+    g_autofree gchar* body_str = NULL;
+    guint count = g_list_length(channels);
+
+    if (count == 1)
     {
-        g_autoptr(GNotification) notification;
-        g_autofree gchar* title_str = NULL;
-        g_autofree gchar* body_str = NULL;
-        GVariant* var = NULL;
+        GtChannel* chan = channels->data;
 
         title_str = g_strdup_printf(_("%s started streaming %s"),
             gt_channel_get_display_name(chan), gt_channel_get_game_name(chan));
         body_str = g_strdup_printf(_("Click here to start watching"));
 
-        var = g_variant_new_string(gt_channel_get_id(chan));
-
         notification = g_notification_new(title_str);
         g_notification_set_body(notification, body_str);
         g_notification_set_default_action_and_target_value(notification,
-            "app.open-channel-from-id", var);
+            "app.open-channel-from-id", g_variant_new_string(gt_channel_get_id(chan)));
+    }
+    else
+    {
+        GString* names = g_string_new(NULL);
+        guint i = 0;
+
+        for (GList* l = channels; l != NULL && i < LIVE_NOTIFICATION_MAX_NAMES; l = l->next, i++)
+        {
+            if (names->len > 0)
+                g_string_append(names, ", ");
+
+            g_string_append(names, gt_channel_get_display_name(l->data));
+        }
 
-        g_application_send_notification(G_APPLICATION(main_app), NULL, notification);
+        if (count > LIVE_NOTIFICATION_MAX_NAMES)
+            g_string_append_printf(names, _(" and %d more"), count - LIVE_NOTIFICATION_MAX_NAMES);
+
+        title_str = g_strdup_printf(_("%d channels started streaming"), count);
+        body_str = g_string_free(names, FALSE);
+
+        notification = g_notification_new(title_str);
+        g_notification_set_body(notification, body_str);
+    }
+
+    //NOTE: A newer one replaces the last instead of piling up
+    g_application_send_notification(G_APPLICATION(main_app), "channels-went-live", notification);
+
+    //NOTE: Good chance the notification gets clicked
+    for (GList* l = channels; l != NULL; l = l->next)
+        gt_twitch_prefetch_streams(main_app->twitch, gt_channel_get_name(l->data));
+}
+
+/* NOTE: Follows are refreshed in bulk by the scheduler like any other
+ * auto-updating channel, this only looks for the ones that went live.
+ * Only a channel that was seen offline by its last refresh counts as
+ * going live, so the first refresh and new follows don't notify. */
+static void
+channels_refreshed_cb(GtChannelScheduler* scheduler,
+    GList* channels, GList* live, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
+
+    GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GList* went_live = NULL;
+
+    for (GList* l = channels; l != NULL; l = l->next)
+    {
+        GtChannel* chan = l->data;
+        const gchar* id = gt_channel_get_id(chan);
+        GList* link = g_hash_table_lookup(priv->follow_index, id);
+        gboolean is_live = g_list_find(live, chan) != NULL;
+        gpointer was_live = NULL;
+        gboolean known;
+
+        //NOTE: Unfollowed while it was being refreshed
+        if (!link || link->data != chan)
+            continue;
+
+        known = g_hash_table_lookup_extended(priv->live_states, id, NULL, &was_live);
+
+        g_hash_table_insert(priv->live_states, g_strdup(id), GINT_TO_POINTER(is_live));
+
+        if (is_live && known && !GPOINTER_TO_INT(was_live) &&
+            gt_app_should_show_notifications(main_app))
+        {
+            went_live = g_list_prepend(went_live, chan);
+        }
+    }
+
+    if (went_live)
+    {
+        MESSAGEF("'%d' followed channels went live", g_list_length(went_live));
+
+        notify_went_live(self, went_live);
+
+        g_list_free(went_live);
     }
 }
 
@@ -116,6 +300,124 @@ toggle_followed_cb(gpointer udata)
     return G_SOURCE_REMOVE;
 }
 
+static void
+show_follow_error(GtChannel* chan, const gchar* title, const gchar* message)
+{
+    GtWin* win = GT_WIN_ACTIVE;
+
+    RETURN_IF_FAIL(GT_IS_WIN(win));
+
+    gt_win_show_error_message(win, title,
+        "%s '%s' because: %s", title, gt_channel_get_name(chan), message);
+}
+
+static void
+add_followed_channel(GtFollowsManager* self, GtChannel* chan)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    const gchar* name = gt_channel_get_name(chan);
+
+    if (g_hash_table_contains(priv->follow_index, gt_channel_get_id(chan)))
+    {
+        DEBUGF("Channel '%s' is already followed", name);
+        return;
+    }
+
+    add_follow(self, chan);
+    g_object_ref(chan);
+
+    if (!gt_app_is_logged_in(main_app))
+        store_local_follow(self, chan);
+
+    g_object_set(chan, "auto-update", TRUE, NULL);
+
+    MESSAGEF("Followed channel '%s'", name);
+
+    g_signal_emit(self, sigs[SIG_CHANNEL_FOLLOWED], 0, chan);
+}
+
+static void
+remove_followed_channel(GtFollowsManager* self, GtChannel* chan)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    GList* found = g_hash_table_lookup(priv->follow_index, gt_channel_get_id(chan));
+
+    if (!found)
+    {
+        DEBUGF("Channel '%s' is already unfollowed", gt_channel_get_name(chan));
+        return;
+    }
+
+    g_object_set(found->data, "auto-update", FALSE, NULL);
+    g_hash_table_remove(priv->live_states, gt_channel_get_id(found->data));
+
+    // Remove the link before the signal is emitted
+    remove_follow(self, gt_channel_get_id(found->data));
+
+    if (!gt_app_is_logged_in(main_app))
+        gt_persistent_file_remove(priv->follows_file, gt_channel_get_id(found->data));
+
+    MESSAGEF("Unfollowed channel '%s'", gt_channel_get_name(chan));
+
+    g_signal_emit(self, sigs[SIG_CHANNEL_UNFOLLOWED], 0, found->data);
+
+    // Unref here so that the GtChannel has a ref while the signal is being emitted
+    g_clear_object(&found->data);
+    g_list_free(found);
+}
+
+static void
+follow_channel_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    g_autoptr(GtChannel) chan = udata;
+    g_autoptr(GError) err = NULL;
+
+    gt_twitch_follow_channel_finish(GT_TWITCH(source), res, &err);
+
+    if (err)
+    {
+        WARNINGF("Unable to follow channel '%s' because: %s",
+            gt_channel_get_name(chan), err->message);
+
+        show_follow_error(chan, "Unable to follow channel", err->message);
+
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) toggle_followed_cb,
+            g_object_ref(chan), g_object_unref);
+
+        return;
+    }
+
+    add_followed_channel(main_app->fav_mgr, chan);
+}
+
+static void
+unfollow_channel_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    g_autoptr(GtChannel) chan = udata;
+    g_autoptr(GError) err = NULL;
+
+    gt_twitch_unfollow_channel_finish(GT_TWITCH(source), res, &err);
+
+    if (err)
+    {
+        WARNINGF("Unable to unfollow channel '%s' because: %s",
+            gt_channel_get_name(chan), err->message);
+
+        show_follow_error(chan, "Unable to unfollow channel", err->message);
+
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) toggle_followed_cb,
+            g_object_ref(chan), g_object_unref);
+
+        return;
+    }
+
+    remove_followed_channel(main_app->fav_mgr, chan);
+}
+
+/* NOTE: Follows go through the async request path so a rate limited
+ * request never blocks the main loop */
 static void
 channel_followed_cb(GObject* source,
     GParamSpec* pspec, gpointer udata)
@@ -124,112 +426,280 @@ channel_followed_cb(GObject* source,
     RETURN_IF_FAIL(GT_IS_CHANNEL(source));
 
     GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
     GtChannel* chan = GT_CHANNEL(source);
-    g_autoptr(GError) err = NULL;
     const gchar* name = gt_channel_get_name(chan);
 
     if (gt_channel_is_followed(chan))
     {
+        if (g_hash_table_contains(priv->follow_index, gt_channel_get_id(chan)))
+        {
+            DEBUGF("Channel '%s' is already followed", name);
+            return;
+        }
+
         if (gt_app_is_logged_in(main_app))
         {
-            gt_twitch_follow_channel(main_app->twitch, name, &err); //TODO: Error handling
-//            gt_twitch_follow_channel_async(main_app->twitch, gt_channel_get_name(chan), NULL, NULL); //TODO: Error handling
+            gt_twitch_follow_channel_async(main_app->twitch, name,
+                follow_channel_cb, g_object_ref(chan));
+        }
+        else
+            add_followed_channel(self, chan);
+    }
+    else
+    {
+        /* NOTE: This should never be false */
+        RETURN_IF_FAIL(g_hash_table_contains(priv->follow_index, gt_channel_get_id(chan)));
 
-            if (err)
-            {
-                GtWin* win = NULL;
+        if (gt_app_is_logged_in(main_app))
+        {
+            gt_twitch_unfollow_channel_async(main_app->twitch, name,
+                unfollow_channel_cb, g_object_ref(chan));
+        }
+        else
+            remove_followed_channel(self, chan);
+    }
+}
+
+typedef struct
+{
+    gint64 time;
+    GList* channels; /* NOTE: Of GtChannelData */
+} SnapshotData;
+
+static void
+snapshot_data_free(SnapshotData* data)
+{
+    gt_channel_data_list_free(data->channels);
 
-                WARNING("Unable to follow channel '%s' because: %s",
-                    name, err->message);
+    g_slice_free(SnapshotData, data);
+}
 
-                win = GT_WIN_ACTIVE;
+//NOTE: Runs on the snapshot file's writer
+static gchar*
+build_snapshot(SnapshotData* data, gsize* len)
+{
+    g_autoptr(JsonBuilder) builder = NULL;
+    g_autoptr(JsonGenerator) gen = NULL;
+    g_autoptr(JsonNode) root = NULL;
 
-                RETURN_IF_FAIL(GT_IS_WIN(win));
+    if (!data->channels)
+        return NULL;
 
-                gt_win_show_error_message(win, "Unable to follow channel",
-                    "Unable to follow channel '%s' because: %s",
-                    name, err->message);
+    builder = json_builder_new();
+    gen = json_generator_new();
 
-                g_idle_add((GSourceFunc) toggle_followed_cb, chan);
+    json_builder_begin_object(builder);
 
-                return;
-            }
-        }
+    json_builder_set_member_name(builder, "version");
+    json_builder_add_int_value(builder, SNAPSHOT_VERSION);
 
-        self->follow_channels = g_list_append(self->follow_channels, chan);
-        g_signal_connect(chan, "notify::online", G_CALLBACK(channel_online_cb), self);
-        g_object_ref(chan);
+    json_builder_set_member_name(builder, "time");
+    json_builder_add_int_value(builder, data->time);
 
-        MESSAGEF("Followed channel '%s'", name);
+    json_builder_set_member_name(builder, "channels");
+    json_builder_begin_array(builder);
 
-        g_signal_emit(self, sigs[SIG_CHANNEL_FOLLOWED], 0, chan);
-    }
-    else
+    for (GList* l = data->channels; l != NULL; l = l->next)
     {
-        GList* found = g_list_find_custom(self->follow_channels, chan, (GCompareFunc) gt_channel_compare);
+        GtChannelData* chan = l->data;
 
-        /* NOTE: This should never be NULL */
-        RETURN_IF_FAIL(found != NULL);
+        json_builder_begin_object(builder);
 
-        if (gt_app_is_logged_in(main_app))
-        {
-//            gt_twitch_unfollow_channel_async(main_app->twitch, gt_channel_get_name(chan), NULL, NULL); //TODO: Error handling
-            gt_twitch_unfollow_channel(main_app->twitch, gt_channel_get_name(chan), &err);
+        json_builder_set_member_name(builder, "id");
+        json_builder_add_string_value(builder, chan->id);
+        json_builder_set_member_name(builder, "name");
+        json_builder_add_string_value(builder, chan->name);
+        json_builder_set_member_name(builder, "display-name");
+        json_builder_add_string_value(builder, chan->display_name);
+        json_builder_set_member_name(builder, "status");
+        json_builder_add_string_value(builder, chan->status);
+        json_builder_set_member_name(builder, "game");
+        json_builder_add_string_value(builder, chan->game);
+        json_builder_set_member_name(builder, "viewers");
+        json_builder_add_int_value(builder, chan->viewers);
+        json_builder_set_member_name(builder, "online");
+        json_builder_add_boolean_value(builder, chan->online);
+        json_builder_set_member_name(builder, "stream-started-time");
+        json_builder_add_int_value(builder, chan->stream_started_time ?
+            g_date_time_to_unix(chan->stream_started_time) : 0);
+        json_builder_set_member_name(builder, "preview-url");
+        json_builder_add_string_value(builder, chan->preview_url);
+        json_builder_set_member_name(builder, "video-banner-url");
+        json_builder_add_string_value(builder, chan->video_banner_url);
+        json_builder_set_member_name(builder, "logo-url");
+        json_builder_add_string_value(builder, chan->logo_url);
+        json_builder_set_member_name(builder, "profile-url");
+        json_builder_add_string_value(builder, chan->profile_url);
 
-            if (err)
-            {
-                GtWin* win = NULL;
+        json_builder_end_object(builder);
+    }
 
-                WARNING("Unable to unfollow channel '%s' because: %s",
-                    name, err->message);
+    json_builder_end_array(builder);
 
-                win = GT_WIN_ACTIVE;
+    json_builder_end_object(builder);
 
-                RETURN_IF_FAIL(GT_IS_WIN(win));
+    root = json_builder_get_root(builder);
 
-                gt_win_show_error_message(win, "Unable to follow channel",
-                    "Unable to follow channel '%s' because: %s",
-                    name, err->message);
+    json_generator_set_root(gen, root);
 
-                g_idle_add((GSourceFunc) toggle_followed_cb, chan);
+    DEBUGF("Saving snapshot of '%d' follows", g_list_length(data->channels));
 
-                return;
-            }
-        }
+    return json_generator_to_data(gen, len);
+}
+
+/* NOTE: Only copies the follows' data here, the JSON is built and
+ * written on the snapshot file's writer */
+static void
+save_snapshot(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    SnapshotData* snapshot = NULL;
 
-        g_signal_handlers_disconnect_by_func(found->data, channel_online_cb, self);
+    //NOTE: Half loaded follows would overwrite a good snapshot
+    if (priv->loading_follows)
+        return;
+
+    //NOTE: Only loading local follows paints from the snapshot
+    if (gt_app_is_logged_in(main_app))
+        return;
 
-        // Remove the link before the signal is emitted
-        self->follow_channels = g_list_remove_link(self->follow_channels, found);
+    snapshot = g_slice_new0(SnapshotData);
+    snapshot->time = g_get_real_time() / G_USEC_PER_SEC;
 
-        MESSAGEF("Unfollowed channel '%s'", gt_channel_get_name(chan));
+    for (GList* l = self->follow_channels; l != NULL; l = l->next)
+    {
+        GtChannelData* data = gt_channel_dup_data(l->data);
 
-        g_signal_emit(self, sigs[SIG_CHANNEL_UNFOLLOWED], 0, found->data);
+        if (!data || utils_str_empty(data->id) || utils_str_empty(data->name))
+        {
+            g_clear_pointer(&data, gt_channel_data_free);
+            continue;
+        }
 
-        // Unref here so that the GtChannel has a ref while the signal is being emitted
-        g_clear_object(&found->data);
-        g_list_free(found);
+        snapshot->channels = g_list_prepend(snapshot->channels, data);
     }
+
+    snapshot->channels = g_list_reverse(snapshot->channels);
+
+    gt_persistent_file_write_async(priv->snapshot_file,
+        (GtPersistentFileBuildFunc) build_snapshot, snapshot,
+        (GDestroyNotify) snapshot_data_free);
 }
 
-static void
-channel_updating_oneshot_cb(GObject* source,
-    GParamSpec* pspec, gpointer udata)
+static gchar*
+read_snapshot_string(JsonReader* reader, const gchar* name)
 {
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
-    RETURN_IF_FAIL(GT_IS_CHANNEL(source));
+    gchar* ret = NULL;
 
-    GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
-    GtChannel* chan = GT_CHANNEL(source);
+    if (json_reader_read_member(reader, name) && !json_reader_get_null_value(reader))
+        ret = g_strdup(json_reader_get_string_value(reader));
 
-    if (!gt_channel_is_updating(chan))
+    json_reader_end_member(reader);
+
+    return ret;
+}
+
+static gint64
+read_snapshot_int(JsonReader* reader, const gchar* name)
+{
+    gint64 ret = 0;
+
+    if (json_reader_read_member(reader, name))
+        ret = json_reader_get_int_value(reader);
+
+    json_reader_end_member(reader);
+
+    return ret;
+}
+
+/* NOTE: Returns the saved data by channel id, a missing or unreadable
+ * snapshot just means everything gets fetched like before */
+static GHashTable*
+parse_snapshot(JsonNode* root, GTimeSpan* age)
+{
+    g_autoptr(JsonReader) reader = NULL;
+    GHashTable* ret = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) gt_channel_data_free);
+    gint64 time;
+
+    if (!root)
+        return ret;
+
+    reader = json_reader_new(root);
+
+    if (read_snapshot_int(reader, "version") != SNAPSHOT_VERSION)
     {
-        g_signal_connect(chan, "notify::online",
-            G_CALLBACK(channel_online_cb), self);
+        MESSAGE("Ignoring follows snapshot with a different version");
+        return ret;
+    }
+
+    time = read_snapshot_int(reader, "time");
+    *age = MAX(g_get_real_time() / G_USEC_PER_SEC - time, 0) * G_TIME_SPAN_SECOND;
 
-        g_signal_handlers_disconnect_by_func(source,
-            channel_updating_oneshot_cb, self);
+    if (!json_reader_read_member(reader, "channels") || !json_reader_is_array(reader))
+    {
+        json_reader_end_member(reader);
+        return ret;
     }
+
+    for (gint i = 0; i < json_reader_count_elements(reader); i++)
+    {
+        GtChannelData* data = NULL;
+        gint64 started;
+
+        if (!json_reader_read_element(reader, i))
+        {
+            json_reader_end_element(reader);
+            continue;
+        }
+
+        data = gt_channel_data_new();
+
+        data->id = read_snapshot_string(reader, "id");
+        data->name = read_snapshot_string(reader, "name");
+        data->display_name = read_snapshot_string(reader, "display-name");
+        data->status = read_snapshot_string(reader, "status");
+        data->game = read_snapshot_string(reader, "game");
+        data->viewers = read_snapshot_int(reader, "viewers");
+        data->preview_url = read_snapshot_string(reader, "preview-url");
+        data->video_banner_url = read_snapshot_string(reader, "video-banner-url");
+        data->logo_url = read_snapshot_string(reader, "logo-url");
+        data->profile_url = read_snapshot_string(reader, "profile-url");
+
+        if (json_reader_read_member(reader, "online"))
+            data->online = json_reader_get_boolean_value(reader);
+        json_reader_end_member(reader);
+
+        started = read_snapshot_int(reader, "stream-started-time");
+
+        if (started > 0)
+            data->stream_started_time = g_date_time_new_from_unix_utc(started);
+
+        json_reader_end_element(reader);
+
+        if (utils_str_empty(data->id) || utils_str_empty(data->name))
+        {
+            gt_channel_data_free(data);
+            continue;
+        }
+
+        g_hash_table_replace(ret, data->id, data);
+    }
+
+    json_reader_end_member(reader);
+
+    return ret;
+}
+
+static gboolean
+snapshot_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata), G_SOURCE_REMOVE);
+
+    save_snapshot(GT_FOLLOWS_MANAGER(udata));
+
+    return G_SOURCE_CONTINUE;
 }
 
 static void
@@ -238,34 +708,23 @@ shutdown_cb(GApplication* app,
 {
     GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
 
-//    gt_follows_manager_save(self);
+    save_snapshot(self);
+
+    gt_follows_manager_save(self);
 }
 
 static GList*
-load_from_file(const char* filepath, GError** error)
+channels_from_json(JsonNode* root, GHashTable* snapshot,
+    GTimeSpan snapshot_age, GError** error)
 {
-    g_autoptr(JsonParser) parser = json_parser_new();
     g_autoptr(JsonReader) reader = NULL;
-    g_autoptr(GError) err = NULL;
     GList* ret = NULL;
 
-    if (!g_file_test(filepath, G_FILE_TEST_EXISTS))
-    {
-        MESSAGE("Follows file at '%s' doesn't exist", filepath);
-
-        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
-            "File '%s' does not exist", filepath);
-
-        return NULL;
-    }
-
-    json_parser_load_from_file(parser, filepath, error);
-
-    reader = json_reader_new(json_parser_get_root(parser));
+    reader = json_reader_new(root);
 
     for (gint i = 0; i < json_reader_count_elements(reader); i++)
     {
-        const gchar* id;
+        g_autofree gchar* id = NULL;
         const gchar* name;
         JsonNode* id_node = NULL;
         GtChannel* chan = NULL;
@@ -292,7 +751,12 @@ load_from_file(const char* filepath, GError** error)
         else if (STRING_EQUALS(json_node_type_name(id_node), "String"))
             id = g_strdup(json_reader_get_string_value(reader));
         else
+        {
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Channel id is neither a string nor an integer");
+
             goto error;
+        }
 
         json_reader_end_element(reader);
 
@@ -309,7 +773,13 @@ load_from_file(const char* filepath, GError** error)
 
         json_reader_end_element(reader);
 
-        chan = gt_channel_new_from_id_and_name(id, name);
+        GtChannelData* data = snapshot ? g_hash_table_lookup(snapshot, id) : NULL;
+
+        //NOTE: Nothing to wait for when we still know what it looked like
+        if (data && STRING_EQUALS(data->name, name))
+            chan = gt_channel_new_from_snapshot(gt_channel_data_copy(data), snapshot_age);
+        else
+            chan = gt_channel_new_from_id_and_name(id, name);
 
         g_object_ref_sink(chan);
 
@@ -321,9 +791,51 @@ load_from_file(const char* filepath, GError** error)
 error:
     gt_channel_list_free(ret);
 
-    return ret;
+    return NULL;
+}
+
+static void
+move_follows_data_free(MoveFollowsData* data)
+{
+    gt_channel_list_free(data->channels);
+    g_free(data->error_message);
+
+    g_slice_free(MoveFollowsData, data);
+}
+
+static void
+move_follows_finish(MoveFollowsData* data)
+{
+    GtFollowsManager* self = data->self;
+
+    if (data->failed > 0)
+    {
+        GtWin* win = GT_WIN_ACTIVE;
+
+        WARNINGF("Unable to move '%d' local follows to Twitch", data->failed);
+
+        //NOTE: The file stays around so moving can be tried again
+        if (GT_IS_WIN(win))
+        {
+            gt_win_show_error_message(win, "Unable to move your local follows to Twitch",
+                "Unable to move your local follows to Twitch because: %s", data->error_message);
+        }
+    }
+    else
+    {
+        g_autofree gchar* fp = FAV_CHANNELS_FILE;
+        g_autofree gchar* new_fp = g_strconcat(fp, ".bak", NULL);
+
+        g_rename(fp, new_fp);
+    }
+
+    move_follows_data_free(data);
+
+    gt_follows_manager_load_from_twitch(self);
 }
 
+static void follow_next_channels(MoveFollowsData* data);
+
 static void
 follow_next_channel_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -331,89 +843,148 @@ follow_next_channel_cb(GObject* source,
     RETURN_IF_FAIL(G_IS_ASYNC_RESULT(res));
     RETURN_IF_FAIL(udata != NULL);
 
-    GList* l = udata;
+    MoveFollowsData* data = udata;
     g_autoptr(GError) err = NULL;
     g_task_propagate_pointer(G_TASK(res), &err); //NOTE: Doesn't return a value
 
+    data->in_flight--;
+
     if (err)
     {
-        GList* last = g_list_last(l);
-
-        RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(last->data));
-
-        GtFollowsManager* self = last->data;
-        GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(udata);
-        GtWin* win = NULL;
+        WARNINGF("Unable to move local follow to Twitch because: %s", err->message);
 
-        win = GT_WIN_ACTIVE;
+        data->failed++;
 
-        RETURN_IF_FAIL(GT_IS_WIN(win));
+        if (!data->error_message)
+            data->error_message = g_strdup(err->message);
+    }
 
-        gt_win_show_error_message(win, "Unable to move your local follows to Twitch",
-            "Unable to move your local follows to Twitch because: %s", err->message);
+    follow_next_channels(data);
+}
 
-        priv->loading_follows = TRUE;
-        g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+/* NOTE: Twitch has no bulk follow, so keep a few follows in flight
+ * instead of waiting on each one in turn */
+static void
+follow_next_channels(MoveFollowsData* data)
+{
+    while (data->next && data->in_flight < MOVE_FOLLOWS_CONCURRENCY)
+    {
+        GtChannel* chan = data->next->data;
 
-        return;
-    }
+        data->next = data->next->next;
+        data->in_flight++;
 
-    if (GT_IS_CHANNEL(l->data))
-    {
         gt_twitch_follow_channel_async(main_app->twitch,
-            gt_channel_get_name(GT_CHANNEL(l->data)),
-            follow_next_channel_cb, l->next);
+            gt_channel_get_name(chan), follow_next_channel_cb, data);
     }
-    else if (GT_IS_FOLLOWS_MANAGER(l->data))
+
+    if (!data->next && data->in_flight == 0)
+        move_follows_finish(data);
+}
+
+//NOTE: Only follow what isn't already followed on Twitch
+static void
+fetch_twitch_follows_for_move_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    RETURN_IF_FAIL(udata != NULL);
+
+    MoveFollowsData* data = udata;
+    g_autoptr(GError) err = NULL;
+    g_autoptr(GHashTable) followed = NULL;
+    GList* existing = NULL;
+    GList* l = NULL;
+
+    existing = gt_twitch_fetch_all_followed_channels_finish(GT_TWITCH(source), res, &err);
+
+    if (err)
+        WARNINGF("Unable to check existing Twitch follows because: %s", err->message);
+
+    followed = g_hash_table_new(g_str_hash, g_str_equal);
+
+    for (l = existing; l != NULL; l = l->next)
+        g_hash_table_add(followed, (gchar*) gt_channel_get_id(l->data));
+
+    l = data->channels;
+
+    while (l != NULL)
     {
-        g_autofree gchar* fp = FAV_CHANNELS_FILE;
-        g_autofree gchar* new_fp = g_strconcat(fp, ".bak", NULL);
+        GList* next = l->next;
 
-        g_rename(fp, new_fp);
+        if (g_hash_table_contains(followed, gt_channel_get_id(l->data)))
+        {
+            g_object_unref(l->data);
+            data->channels = g_list_delete_link(data->channels, l);
+        }
 
-        gt_follows_manager_load_from_twitch(GT_FOLLOWS_MANAGER(l->data));
+        l = next;
     }
-    else
-        RETURN_IF_REACHED();
+
+    g_clear_pointer(&followed, g_hash_table_unref);
+    gt_channel_list_free(existing);
+
+    MESSAGEF("Moving '%d' local follows to Twitch", g_list_length(data->channels));
+
+    data->next = data->channels;
+
+    follow_next_channels(data);
 }
 
 static void
-move_local_follows_cb(GtkInfoBar* bar,
-    gint res, gpointer udata)
+read_local_follows_for_move_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
 {
     RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
 
     GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
+    g_autoptr(JsonNode) root = NULL;
+    g_autoptr(GError) err = NULL;
+    GList* channels = NULL;
 
-    if (res == GTK_RESPONSE_YES)
+    root = gt_persistent_file_read_finish(res, &err);
+
+    if (!err)
+        channels = channels_from_json(root, NULL, 0, &err);
+
+    if (err)
     {
-        g_autofree gchar* filepath = FAV_CHANNELS_FILE;
-        g_autoptr(GError) err = NULL;
-        GList* channels = NULL;
+        GtWin* win;
 
-        channels = load_from_file(filepath, &err);
+        WARNING("Unable to move local follows to Twitch because: %s", err->message);
 
-        if (err)
-        {
-            GtWin* win;
+        win = GT_WIN_ACTIVE;
 
-            WARNING("Unable to move local follows to Twitch because: %s", err->message);
+        RETURN_IF_FAIL(GT_IS_WIN(win));
 
-            win = GT_WIN_ACTIVE;
+        gt_win_show_error_message(win, "Unable to move your local folllows to Twitch",
+            "Unable to move local follows to Twitch because: %s", err->message);
 
-            RETURN_IF_FAIL(GT_IS_WIN(win));
+        return;
+    }
 
-            gt_win_show_error_message(win, "Unable to move your local folllows to Twitch",
-                "Unable to move local follows to Twitch because: %s", err->message);
+    const GtOAuthInfo* info = gt_app_get_oauth_info(main_app);
+    MoveFollowsData* data = g_slice_new0(MoveFollowsData);
 
-            return;
-        }
+    data->self = self;
+    data->channels = channels;
 
-        channels = g_list_append(channels, self);
+    gt_twitch_fetch_all_followed_channels_async(main_app->twitch,
+        info->user_id, info->oauth_token, NULL, fetch_twitch_follows_for_move_cb, data);
+}
 
-        gt_twitch_follow_channel_async(main_app->twitch,
-            gt_channel_get_name(GT_CHANNEL(channels->data)),
-            follow_next_channel_cb, channels->next);
+static void
+move_local_follows_cb(GtkInfoBar* bar,
+    gint res, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
+
+    GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
+
+    if (res == GTK_RESPONSE_YES)
+    {
+        g_autofree gchar* filepath = FAV_CHANNELS_FILE;
+
+        gt_persistent_file_read_async(filepath, NULL, read_local_follows_for_move_cb, self);
     }
     else
     {
@@ -450,6 +1021,33 @@ logged_in_cb(GObject* source,
         gt_follows_manager_load_from_file(self);
 }
 
+//NOTE: Stop the old follows from being refreshed before letting go of them
+static void
+clear_follows(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    for (GList* l = self->follow_channels; l != NULL; l = l->next)
+        g_object_set(l->data, "auto-update", FALSE, NULL);
+
+    g_hash_table_remove_all(priv->live_states);
+
+    g_clear_pointer(&self->follow_channels,
+        (GDestroyNotify) gt_channel_list_free);
+
+    index_follows(self);
+}
+
+//NOTE: Every load that isn't cancelled by a newer one ends here
+static void
+finish_loading(GtFollowsManager* self)
+{
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    priv->loading_follows = FALSE;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+}
+
 static void
 fetch_all_followed_channels_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -457,37 +1055,36 @@ fetch_all_followed_channels_cb(GObject* source,
     RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(udata));
 
     GtFollowsManager* self = GT_FOLLOWS_MANAGER(udata);
-    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
 
     g_autoptr(GError) err = NULL;
     GList* list = NULL;
 
     list = gt_twitch_fetch_all_followed_channels_finish(GT_TWITCH(source), res, &err);
 
-    g_clear_pointer(&self->follow_channels,
-        (GDestroyNotify) gt_channel_list_free);
+    clear_follows(self);
 
     if (err)
     {
         if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
         {
-
             GtWin* win = GT_WIN_ACTIVE;
 
-            RETURN_IF_FAIL(GT_IS_WIN(win));
-
             WARNING("Unable to fetch Twitch follows because: %s", err->message);
 
+            finish_loading(self);
+
+            RETURN_IF_FAIL(GT_IS_WIN(win));
+
             gt_win_show_error_message(win,
                 "Unable to fetch your Twitch follows",
                 err->message);
-
         }
 
         return;
     }
 
     self->follow_channels = list;
+    index_follows(self);
 
     if (self->follow_channels)
     {
@@ -500,9 +1097,6 @@ fetch_all_followed_channels_cb(GObject* source,
 
             g_object_ref_sink(chan);
 
-            g_signal_connect(chan, "notify::updating",
-                G_CALLBACK(channel_updating_oneshot_cb), self);
-
             g_signal_handlers_block_by_func(chan, channel_followed_cb, self);
 
             g_object_set(chan,
@@ -518,16 +1112,25 @@ fetch_all_followed_channels_cb(GObject* source,
 
     MESSAGE("Loaded '%d' follows from Twitch", g_list_length(self->follow_channels));
 
-    priv->loading_follows = FALSE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+    finish_loading(self);
 }
 
 static void
 finalize(GObject* object)
 {
     GtFollowsManager* self = (GtFollowsManager*) object;
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
+    if (priv->snapshot_id > 0)
+        g_source_remove(priv->snapshot_id);
+
+    g_signal_handlers_disconnect_by_func(main_app->scheduler, channels_refreshed_cb, self);
 
     gt_channel_list_free(self->follow_channels);
+    g_hash_table_unref(priv->follow_index);
+    g_hash_table_unref(priv->live_states);
+    g_object_unref(priv->follows_file);
+    g_object_unref(priv->snapshot_file);
 
     G_OBJECT_CLASS(gt_follows_manager_parent_class)->finalize(object);
 }
@@ -592,14 +1195,26 @@ gt_follows_manager_init(GtFollowsManager* self)
 {
     g_assert(GT_IS_FOLLOWS_MANAGER(self));
 
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+
     self->follow_channels = NULL;
+    priv->follow_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    priv->follow_tail = NULL;
+    priv->live_states = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
     g_autofree gchar* old_fp = OLD_FAV_CHANNELS_FILE;
     g_autofree gchar* new_fp = FAV_CHANNELS_FILE;
+    g_autofree gchar* snapshot_fp = SNAPSHOT_FILE;
+
+    priv->follows_file = gt_persistent_file_new(new_fp, "[", "]");
+    priv->snapshot_file = gt_persistent_file_new(snapshot_fp, NULL, NULL);
 
     g_signal_connect(main_app, "shutdown", G_CALLBACK(shutdown_cb), self);
     g_signal_connect(main_app, "notify::logged-in", G_CALLBACK(logged_in_cb), self);
 
+    priv->snapshot_id = g_timeout_add_seconds(SNAPSHOT_INTERVAL, snapshot_cb, self);
+    g_signal_connect(main_app->scheduler, "channels-refreshed", G_CALLBACK(channels_refreshed_cb), self);
+
     //TODO: Remove this in a release or two
     if (g_file_test(old_fp, G_FILE_TEST_EXISTS))
         g_rename(old_fp, new_fp);
@@ -623,42 +1238,60 @@ gt_follows_manager_load_from_twitch(GtFollowsManager* self)
         info->user_id, info->oauth_token, priv->cancel, fetch_all_followed_channels_cb, self);
 }
 
-void
-gt_follows_manager_load_from_file(GtFollowsManager* self)
+static void
+load_follows_data_free(LoadFollowsData* data)
 {
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
+    g_clear_pointer(&data->follows, json_node_unref);
+
+    g_slice_free(LoadFollowsData, data);
+}
 
+static void
+read_snapshot_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    LoadFollowsData* data = udata;
+    GtFollowsManager* self = data->self;
     GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
-    g_autofree gchar* filepath = FAV_CHANNELS_FILE;
     g_autoptr(GError) err = NULL;
+    g_autoptr(JsonNode) snapshot_root = NULL;
+    g_autoptr(GHashTable) snapshot = NULL;
+    GTimeSpan snapshot_age = G_MAXINT64;
+    GList* revalidate = NULL;
 
-    priv->loading_follows = TRUE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+    snapshot_root = gt_persistent_file_read_finish(res, &err);
 
-    g_clear_pointer(&self->follow_channels,
-        (GDestroyNotify) gt_channel_list_free);
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        goto out;
+    else if (err && !g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+        WARNINGF("Unable to load follows snapshot because: %s", err->message);
 
-    self->follow_channels = load_from_file(filepath, &err);
+    g_clear_error(&err);
+
+    snapshot = parse_snapshot(snapshot_root, &snapshot_age);
+
+    self->follow_channels = channels_from_json(data->follows, snapshot, snapshot_age, &err);
+    index_follows(self);
 
     if (err)
     {
-        if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-            goto finish;
-        else
-        {
-            GtWin* win = GT_WIN_ACTIVE;
+        GtWin* win = GT_WIN_ACTIVE;
 
-            RETURN_IF_FAIL(GT_IS_WIN(win));
-
-            WARNING("Error loading followed channels from file because: %s", err->message);
+        WARNING("Error loading followed channels from file because: %s", err->message);
 
+        if (GT_IS_WIN(win))
+        {
             gt_win_show_error_message(win, "Unable to load followed channels from file",
                 "Unable to load followed channels from file because: %s", err->message);
         }
 
-        return;
+        finish_loading(self);
+
+        goto out;
     }
 
+    gt_persistent_file_clear(priv->follows_file);
+
     for (GList* l = self->follow_channels; l != NULL; l = l->next)
     {
         GtChannel* chan = l->data;
@@ -674,76 +1307,114 @@ gt_follows_manager_load_from_file(GtFollowsManager* self)
 
         g_signal_handlers_unblock_by_func(chan, channel_followed_cb, self);
 
-        g_signal_connect(chan, "notify::updating", G_CALLBACK(channel_updating_oneshot_cb), self);
+        store_local_follow(self, chan);
+
+        if (g_hash_table_contains(snapshot, gt_channel_get_id(chan)))
+            revalidate = g_list_prepend(revalidate, chan);
     }
 
-    MESSAGE("Loaded '%d' follows from file", g_list_length(self->follow_channels));
+    //NOTE: What's on disk is what we just loaded
+    gt_persistent_file_mark_saved(priv->follows_file);
 
-finish:
-    priv->loading_follows = FALSE;
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
+    MESSAGEF("Loaded '%d' follows from file, '%d' of them from the snapshot",
+        g_list_length(self->follow_channels), g_list_length(revalidate));
 
-    return;
+    finish_loading(self);
+
+    //NOTE: Only the ones shown from the snapshot, the rest are being fetched already
+    gt_channel_scheduler_refresh_now(main_app->scheduler, revalidate);
+
+    g_list_free(revalidate);
+
+out:
+    load_follows_data_free(data);
 }
 
-void
-gt_follows_manager_save(GtFollowsManager* self)
+static void
+read_local_follows_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
 {
-    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
-
-    g_autofree gchar* fp = FAV_CHANNELS_FILE;
+    LoadFollowsData* data = udata;
+    GtFollowsManager* self = data->self;
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    g_autofree gchar* fp = SNAPSHOT_FILE;
+    g_autoptr(GError) err = NULL;
 
-    MESSAGE("Saving follows fo file '%s'", fp);
+    data->follows = gt_persistent_file_read_finish(res, &err);
 
-    if (g_list_length(self->follow_channels) == 0)
+    if (err)
     {
-        if (g_file_test(fp, G_FILE_TEST_EXISTS))
+        if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
         {
-            g_remove(fp);
-            g_free(fp);
+            MESSAGE("No local follows to load");
+
+            gt_persistent_file_clear(priv->follows_file);
+            gt_persistent_file_mark_saved(priv->follows_file);
+
+            finish_loading(self);
         }
+        else if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        {
+            GtWin* win = GT_WIN_ACTIVE;
 
-        return;
-    }
+            WARNING("Error loading followed channels from file because: %s", err->message);
 
-    g_autoptr(JsonBuilder) builder = json_builder_new();
-    g_autoptr(JsonGenerator) gen = json_generator_new();
-    g_autoptr(JsonNode) final = NULL;
+            if (GT_IS_WIN(win))
+            {
+                gt_win_show_error_message(win, "Unable to load followed channels from file",
+                    "Unable to load followed channels from file because: %s", err->message);
+            }
 
-    //NOTE: I'll just leave this here in case I want to include
-    //a version tag in the future
+            finish_loading(self);
+        }
 
-    /* json_builder_begin_object(builder); */
+        load_follows_data_free(data);
 
-    /* json_builder_set_member_name(builder, "version"); */
-    /* json_builder_add_int_value(builder, FOLLOWED_CHANNELS_FILE_VERSION); */
-    /* json_builder_end_object(builder); */
+        return;
+    }
 
-    /* json_builder_set_member_name(builder, "followed-channels"); */
+    gt_persistent_file_read_async(fp, priv->cancel, read_snapshot_cb, data);
+}
 
-    json_builder_begin_array(builder);
+/* NOTE: Both the follows and their snapshot are read and parsed on a
+ * worker, only building the channels happens on the main thread */
+void
+gt_follows_manager_load_from_file(GtFollowsManager* self)
+{
+    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
 
-    for (GList* l = self->follow_channels; l != NULL; l = l->next)
-    {
-        json_builder_begin_object(builder);
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    g_autofree gchar* filepath = FAV_CHANNELS_FILE;
+    LoadFollowsData* data = g_slice_new0(LoadFollowsData);
 
-        json_builder_set_member_name(builder, "id");
-        json_builder_add_string_value(builder, gt_channel_get_id(l->data));
+    priv->loading_follows = TRUE;
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_LOADING_FOLLOWS]);
 
-        json_builder_set_member_name(builder, "name");
-        json_builder_add_string_value(builder, gt_channel_get_name(l->data));
+    clear_follows(self);
 
-        json_builder_end_object(builder);
-    }
+    utils_refresh_cancellable(&priv->cancel);
 
-    json_builder_end_array(builder);
+    data->self = self;
 
-    /* json_builder_end_object(builder); */
+    gt_persistent_file_read_async(filepath, priv->cancel, read_local_follows_cb, data);
+}
 
-    final = json_builder_get_root(builder);
+/* NOTE: Local follows and the snapshot are written as they change, this
+ * only makes sure the last of them made it to disk. Both share one
+ * deadline so shutdown never waits longer than the timeout. */
+void
+gt_follows_manager_save(GtFollowsManager* self)
+{
+    RETURN_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self));
+
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    gint64 deadline = g_get_monotonic_time() + FOLLOWED_CHANNELS_FLUSH_TIMEOUT;
 
-    json_generator_set_root(gen, final);
-    json_generator_to_file(gen, fp, NULL);
+    MESSAGE("Saving follows");
+
+    gt_persistent_file_flush(priv->follows_file, FOLLOWED_CHANNELS_FLUSH_TIMEOUT);
+    gt_persistent_file_flush(priv->snapshot_file,
+        MAX(deadline - g_get_monotonic_time(), 0));
 }
 
 gboolean
@@ -752,7 +1423,10 @@ gt_follows_manager_is_channel_followed(GtFollowsManager* self, GtChannel* chan)
     RETURN_VAL_IF_FAIL(GT_IS_FOLLOWS_MANAGER(self), FALSE);
     RETURN_VAL_IF_FAIL(GT_IS_CHANNEL(chan), FALSE);
 
-    return g_list_find_custom(self->follow_channels, chan, (GCompareFunc) gt_channel_compare) != NULL;
+    GtFollowsManagerPrivate* priv = gt_follows_manager_get_instance_private(self);
+    const gchar* id = gt_channel_get_id(chan);
+
+    return id && g_hash_table_contains(priv->follow_index, id);
 }
 
 gboolean
@@ -26,6 +26,9 @@
 #define TAG "GtGame"
 #include "gnome-twitch/gt-log.h"
 
+#define PREVIEW_WIDTH 200
+#define PREVIEW_HEIGHT 270
+
 typedef struct
 {
     GtGameData* data;
@@ -36,6 +39,7 @@ typedef struct
 
     GdkPixbuf* logo;
 
+    GtResourceDownloaderPriority preview_priority;
     GCancellable* cancel;
 
     guint notify_source_id;
@@ -82,9 +86,22 @@ notify_preview_cb(gpointer udata)
 static void
 download_image_cb(GdkPixbuf* pixbuf, gpointer udata, GError* error)
 {
-    RETURN_IF_FAIL(GT_IS_GAME(udata));
+    RETURN_IF_FAIL(udata != NULL);
+
+    g_autoptr(GtGame) self = g_weak_ref_get(udata);
+
+    utils_free_weak_ref(udata);
+
+    if (!self || g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+        TRACE("Not setting preview because the download was cancelled");
+
+        g_clear_error(&error);
+        g_clear_object(&pixbuf);
+
+        return;
+    }
 
-    GtGame* self = GT_GAME(udata);
     GtGamePrivate* priv = gt_game_get_instance_private(self);
 
     /* FIXME: Propagate error */
@@ -92,18 +109,20 @@ download_image_cb(GdkPixbuf* pixbuf, gpointer udata, GError* error)
 
     if (pixbuf)
     {
-        priv->preview = pixbuf;
+        utils_pixbuf_scale_simple(&pixbuf,
+            PREVIEW_WIDTH, PREVIEW_HEIGHT, GDK_INTERP_BILINEAR);
 
-        utils_pixbuf_scale_simple(&priv->preview,
-            200, 270, GDK_INTERP_BILINEAR);
+        gt_resource_downloader_share_image(priv->data->preview_url,
+            PREVIEW_WIDTH, PREVIEW_HEIGHT, pixbuf);
+
+        g_clear_object(&priv->preview);
+        priv->preview = pixbuf;
     }
 
     if (priv->notify_source_id == 0)
     {
-        /* NOTE: Don't need to ref ourselves because we are in a async
-         * cb */
         priv->notify_source_id = g_idle_add_full(G_PRIORITY_LOW,
-            notify_preview_cb, self, g_object_unref);
+            notify_preview_cb, g_object_ref(self), g_object_unref);
     }
 }
 
@@ -114,16 +133,33 @@ update_preview(GtGame* self)
 
     GtGamePrivate* priv = gt_game_get_instance_private(self);
 
-    /* utils_refresh_cancellable(&priv->cancel); */
+    utils_refresh_cancellable(&priv->cancel);
+
+    /* NOTE: Box art never changes for a given url, so any decoded copy will do */
+    GdkPixbuf* preview = gt_resource_downloader_lookup_shared_image(
+        priv->data->preview_url, PREVIEW_WIDTH, PREVIEW_HEIGHT, -1);
+
+    if (!preview)
+    {
+        /* FIXME: Handle error below */
+        preview = gt_resource_downloader_download_image_immediately(res_downloader,
+            priv->data->preview_url, priv->data->id, priv->preview_priority, priv->cancel,
+            download_image_cb, utils_create_weak_ref(self), NULL);
+
+        if (preview)
+        {
+            utils_pixbuf_scale_simple(&preview,
+                PREVIEW_WIDTH, PREVIEW_HEIGHT, GDK_INTERP_BILINEAR);
 
-    /* FIXME: Handle error below */
-    priv->preview = gt_resource_downloader_download_image_immediately(res_downloader,
-        priv->data->preview_url, priv->data->id, download_image_cb, g_object_ref(self), NULL);
+            gt_resource_downloader_share_image(priv->data->preview_url,
+                PREVIEW_WIDTH, PREVIEW_HEIGHT, preview);
+        }
+    }
 
-    if (priv->preview)
+    if (preview)
     {
-        utils_pixbuf_scale_simple(&priv->preview,
-            200, 270, GDK_INTERP_BILINEAR);
+        g_clear_object(&priv->preview);
+        priv->preview = preview;
 
         if (priv->notify_source_id == 0)
         {
@@ -187,6 +223,9 @@ dispose(GObject* object)
     GtGame* self = GT_GAME(object);
     GtGamePrivate* priv = gt_game_get_instance_private(self);
 
+    g_cancellable_cancel(priv->cancel);
+
+    g_clear_object(&priv->cancel);
     g_clear_object(&priv->preview);
     g_clear_object(&priv->logo);
 
@@ -316,6 +355,8 @@ gt_game_init(GtGame* self)
     priv->updating = FALSE;
     priv->preview = NULL;
     priv->logo = NULL;
+    priv->preview_priority = GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND;
+    priv->cancel = NULL;
 }
 
 GtGame*
@@ -356,6 +397,22 @@ gt_game_get_updating(GtGame* self)
     return priv->updating;
 }
 
+void
+gt_game_set_preview_priority(GtGame* self, GtResourceDownloaderPriority priority)
+{
+    RETURN_IF_FAIL(GT_IS_GAME(self));
+
+    GtGamePrivate* priv = gt_game_get_instance_private(self);
+
+    if (priv->preview_priority == priority)
+        return;
+
+    priv->preview_priority = priority;
+
+    if (priv->cancel)
+        gt_resource_downloader_set_priority(res_downloader, priv->cancel, priority);
+}
+
 gint64
 gt_game_get_viewers(GtGame* self)
 {
@@ -20,6 +20,7 @@
 #define GT_GAME_H
 
 #include <gtk/gtk.h>
+#include "gt-resource-downloader.h"
 
 G_BEGIN_DECLS
 
@@ -48,6 +49,7 @@ void         gt_game_list_free(GList* self);
 const gchar* gt_game_get_name(GtGame* self);
 gboolean     gt_game_get_updating(GtGame* self);
 gint64       gt_game_get_viewers(GtGame* self);
+void         gt_game_set_preview_priority(GtGame* self, GtResourceDownloaderPriority priority);
 GtGameData*  gt_game_data_new();
 void         gt_game_data_free(GtGameData* data);
 
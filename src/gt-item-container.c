@@ -19,10 +19,14 @@
 #include "gt-item-container.h"
 #include "utils.h"
 #include "gt-win.h"
+#include "gt-channel.h"
+#include "gt-game.h"
 
 #define TAG "GtItemContainer"
 #include "gnome-twitch/gt-log.h"
 
+#define GRID_SPARE_ROWS 1 /* NOTE: Bound above and below the viewport so tiles are in place before they scroll in */
+
 typedef struct
 {
     GtkWidget* item_scroll;
@@ -46,12 +50,27 @@ typedef struct
     gchar* error_label_text;
 
     GList* items;
+    GHashTable* item_children; /* NOTE: Item to the child showing it, or to its priority in the grid */
     guint num_items;
     gboolean fetching_items;
 
+    /* NOTE: Only used when the subclass implements bind_child */
+    gboolean virtual_grid;
+    GtkWidget* item_grid;
+    GPtrArray* item_array;
+    GPtrArray* tiles;
+    gint grid_width;
+    gint grid_columns;
+    gint grid_column_width;
+    gint grid_row_height;
+    gint pressed_index;
+    guint layout_tiles_id;
+
     GCancellable* cancel;
 
     GdkRectangle* alloc;
+
+    guint update_priorities_id;
 } GtItemContainerPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE(GtItemContainer, gt_item_container, GTK_TYPE_STACK);
@@ -65,6 +84,433 @@ enum
 
 static GParamSpec* props[NUM_PROPS];
 
+static GtResourceDownloaderPriority
+priority_for_rect(gint y, gint height, gdouble top, gdouble page)
+{
+    if (y + height >= top && y <= top + page)
+        return GT_RESOURCE_DOWNLOADER_PRIORITY_VISIBLE;
+    else if (y + height >= top - page && y <= top + page*2)
+        return GT_RESOURCE_DOWNLOADER_PRIORITY_NEAR_VISIBLE;
+
+    return GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND;
+}
+
+static gboolean
+update_priorities_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), G_SOURCE_REMOVE);
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll));
+    gdouble page = gtk_adjustment_get_page_size(vadj);
+    gdouble top = gtk_adjustment_get_value(vadj);
+    GtkWidget* toplevel = gtk_widget_get_toplevel(GTK_WIDGET(self));
+    gboolean mapped = gtk_widget_get_mapped(GTK_WIDGET(self));
+
+    priv->update_priorities_id = 0;
+
+    /* NOTE: A minimised window stays mapped as far as GTK is concerned */
+    if (mapped && gtk_widget_is_toplevel(toplevel) &&
+        gdk_window_get_state(gtk_widget_get_window(toplevel)) & GDK_WINDOW_STATE_ICONIFIED)
+    {
+        mapped = FALSE;
+    }
+
+    /* NOTE: Grid items have no child of their own, their position follows from their index */
+    if (priv->virtual_grid)
+    {
+        for (guint i = 0; i < priv->item_array->len; i++)
+        {
+            gpointer item = g_ptr_array_index(priv->item_array, i);
+            GtResourceDownloaderPriority priority = GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND;
+
+            if (mapped && priv->grid_columns > 0)
+            {
+                priority = priority_for_rect(i / priv->grid_columns * priv->grid_row_height,
+                    priv->grid_row_height, top, page);
+            }
+
+            if (GPOINTER_TO_INT(g_hash_table_lookup(priv->item_children, item)) != priority + 1)
+            {
+                g_hash_table_insert(priv->item_children, item, GINT_TO_POINTER(priority + 1));
+
+                GT_ITEM_CONTAINER_GET_CLASS(self)->set_item_priority(self, item, priority);
+            }
+        }
+
+        return G_SOURCE_REMOVE;
+    }
+
+    GtkWidget* content = gtk_widget_get_parent(priv->item_flow);
+    GList* children = gtk_container_get_children(GTK_CONTAINER(priv->item_flow));
+
+    for (GList* l = children; l != NULL; l = l->next)
+    {
+        GtkWidget* child = GTK_WIDGET(l->data);
+        gpointer item = g_object_get_data(G_OBJECT(child), "item");
+        GtResourceDownloaderPriority priority = GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND;
+        gint y = 0;
+
+        if (!item)
+            continue;
+
+        /* NOTE: Everything is in the background while we aren't shown */
+        if (mapped && gtk_widget_translate_coordinates(child, content, 0, 0, NULL, &y))
+            priority = priority_for_rect(y, gtk_widget_get_allocated_height(child), top, page);
+
+        /* NOTE: Stored off by one so we can tell unset apart from VISIBLE */
+        if (GPOINTER_TO_INT(g_object_get_data(G_OBJECT(child), "priority")) != priority + 1)
+        {
+            g_object_set_data(G_OBJECT(child), "priority", GINT_TO_POINTER(priority + 1));
+
+            GT_ITEM_CONTAINER_GET_CLASS(self)->set_item_priority(self, item, priority);
+        }
+    }
+
+    g_list_free(children);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+update_priorities(GtItemContainer* self)
+{
+    g_assert(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (!GT_ITEM_CONTAINER_GET_CLASS(self)->set_item_priority)
+        return;
+
+    /* NOTE: Scrolling fires this every frame, only do the work once per batch */
+    if (priv->update_priorities_id == 0)
+    {
+        priv->update_priorities_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+            update_priorities_cb, self, NULL);
+    }
+}
+
+static gboolean
+window_state_cb(GtkWidget* window,
+    GdkEventWindowState* evt, gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), GDK_EVENT_PROPAGATE);
+
+    if (evt->changed_mask & GDK_WINDOW_STATE_ICONIFIED)
+        update_priorities(GT_ITEM_CONTAINER(udata));
+
+    return GDK_EVENT_PROPAGATE;
+}
+
+static void
+hierarchy_changed_cb(GtkWidget* widget,
+    GtkWidget* prev_toplevel, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(widget));
+
+    GtkWidget* toplevel = gtk_widget_get_toplevel(widget);
+
+    if (prev_toplevel)
+        g_signal_handlers_disconnect_by_func(prev_toplevel, window_state_cb, widget);
+
+    if (GTK_IS_WINDOW(toplevel))
+    {
+        g_signal_connect_object(toplevel, "window-state-event",
+            G_CALLBACK(window_state_cb), widget, 0);
+    }
+}
+
+static void
+tile_activate_cb(GtkFlowBoxChild* tile, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(udata));
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+
+    GT_ITEM_CONTAINER_GET_CLASS(self)->activate_child(self, tile);
+}
+
+static GtkWidget*
+create_tile(GtItemContainer* self, gpointer item)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkWidget* tile = GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, item);
+
+    g_object_set_data(G_OBJECT(tile), "item", item);
+
+    g_signal_connect(tile, "activate", G_CALLBACK(tile_activate_cb), self);
+
+    gtk_fixed_put(GTK_FIXED(priv->item_grid), tile, 0, 0);
+    g_ptr_array_add(priv->tiles, tile);
+
+    return tile;
+}
+
+/* NOTE: Only enough tiles to cover the viewport exist, items are bound to
+ * them by index modulo the pool size so a tile keeps its item for as long as
+ * the item stays in range and only the tiles scrolling in are rebound */
+static gboolean
+layout_tiles_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), G_SOURCE_REMOVE);
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll));
+    gint width = gtk_widget_get_allocated_width(priv->item_grid);
+    guint num_rows, num_tiles, first;
+    gint first_row;
+
+    priv->layout_tiles_id = 0;
+
+    if (width <= 1)
+        return G_SOURCE_REMOVE;
+
+    priv->grid_width = width;
+    priv->grid_columns = MAX(width / priv->child_width, 1);
+    priv->grid_column_width = width / priv->grid_columns;
+    priv->grid_row_height = priv->child_height;
+
+    /* NOTE: Every tile is the same kind of widget so any of them gives the row height */
+    if (priv->tiles->len > 0)
+    {
+        gint height = 0;
+
+        gtk_widget_get_preferred_height_for_width(g_ptr_array_index(priv->tiles, 0),
+            priv->grid_column_width, NULL, &height);
+
+        if (height > 0)
+            priv->grid_row_height = height;
+    }
+
+    num_rows = (priv->item_array->len + priv->grid_columns - 1) / priv->grid_columns;
+
+    gtk_widget_set_size_request(priv->item_grid, -1, num_rows*priv->grid_row_height);
+
+    first_row = MAX((gint) (gtk_adjustment_get_value(vadj) / priv->grid_row_height) - GRID_SPARE_ROWS, 0);
+    first = first_row*priv->grid_columns;
+
+    num_tiles = ((gint) gtk_adjustment_get_page_size(vadj) / priv->grid_row_height + 2 + GRID_SPARE_ROWS*2)
+        * priv->grid_columns;
+    num_tiles = MIN(num_tiles, priv->item_array->len);
+
+    while (priv->tiles->len > num_tiles)
+    {
+        gtk_widget_destroy(g_ptr_array_index(priv->tiles, priv->tiles->len - 1));
+        g_ptr_array_remove_index(priv->tiles, priv->tiles->len - 1);
+    }
+
+    while (priv->tiles->len < num_tiles)
+    {
+        guint index = MIN(first + priv->tiles->len, priv->item_array->len - 1);
+
+        create_tile(self, g_ptr_array_index(priv->item_array, index));
+    }
+
+    for (guint i = 0; i < num_tiles; i++)
+    {
+        guint index = first + i;
+        GtkWidget* tile = g_ptr_array_index(priv->tiles, index % num_tiles);
+        gpointer item = NULL;
+        gint x, y, cur_x, cur_y;
+
+        if (index >= priv->item_array->len)
+        {
+            gtk_widget_hide(tile);
+            continue;
+        }
+
+        item = g_ptr_array_index(priv->item_array, index);
+
+        if (g_object_get_data(G_OBJECT(tile), "item") != item)
+        {
+            GT_ITEM_CONTAINER_GET_CLASS(self)->bind_child(self, tile, item);
+            g_object_set_data(G_OBJECT(tile), "item", item);
+        }
+
+        x = index % priv->grid_columns * priv->grid_column_width;
+        y = index / priv->grid_columns * priv->grid_row_height;
+
+        gtk_container_child_get(GTK_CONTAINER(priv->item_grid), tile, "x", &cur_x, "y", &cur_y, NULL);
+
+        /* NOTE: Moving always queues a resize, even to the same spot */
+        if (x != cur_x || y != cur_y)
+            gtk_fixed_move(GTK_FIXED(priv->item_grid), tile, x, y);
+
+        gtk_widget_set_size_request(tile, priv->grid_column_width, -1);
+        gtk_widget_show(tile);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+layout_tiles(GtItemContainer* self)
+{
+    g_assert(GT_IS_ITEM_CONTAINER(self));
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    /* NOTE: Run ahead of GTK's own resizing and redrawing so the tiles are in place for the next frame */
+    if (priv->layout_tiles_id == 0)
+    {
+        priv->layout_tiles_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE + 5,
+            layout_tiles_cb, self, NULL);
+    }
+}
+
+static void
+grid_size_allocate_cb(GtkWidget* widget,
+    GdkRectangle* alloc, gpointer udata)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(udata));
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    //NOTE: Our own size requests allocate us again, only the width changes the grid
+    if (alloc->width != priv->grid_width)
+        layout_tiles(self);
+
+    update_priorities(self);
+}
+
+static gint
+grid_index_at(GtItemContainer* self, GdkEventButton* evt)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    gint x, y, column, index;
+
+    if (priv->grid_columns == 0)
+        return -1;
+
+    //NOTE: The event could have come from one of the tile's own windows
+    gdk_window_get_origin(gtk_widget_get_window(priv->item_grid), &x, &y);
+
+    x = evt->x_root - x;
+    y = evt->y_root - y;
+    column = x / priv->grid_column_width;
+
+    if (x < 0 || y < 0 || column >= priv->grid_columns)
+        return -1;
+
+    index = y / priv->grid_row_height * priv->grid_columns + column;
+
+    return index < (gint) priv->item_array->len ? index : -1;
+}
+
+static gboolean
+grid_button_press_cb(GtkWidget* widget,
+    GdkEventButton* evt, gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), GDK_EVENT_PROPAGATE);
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (evt->type == GDK_BUTTON_PRESS && evt->button == GDK_BUTTON_PRIMARY)
+        priv->pressed_index = grid_index_at(self, evt);
+
+    return GDK_EVENT_PROPAGATE;
+}
+
+static gboolean
+grid_button_release_cb(GtkWidget* widget,
+    GdkEventButton* evt, gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_ITEM_CONTAINER(udata), GDK_EVENT_PROPAGATE);
+
+    GtItemContainer* self = GT_ITEM_CONTAINER(udata);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    gint index = evt->button == GDK_BUTTON_PRIMARY ? grid_index_at(self, evt) : -1;
+    GtkWidget* tile = NULL;
+
+    if (index < 0 || index != priv->pressed_index || priv->tiles->len == 0)
+        return GDK_EVENT_PROPAGATE;
+
+    priv->pressed_index = -1;
+
+    tile = g_ptr_array_index(priv->tiles, index % priv->tiles->len);
+
+    if (g_object_get_data(G_OBJECT(tile), "item") != g_ptr_array_index(priv->item_array, index))
+        return GDK_EVENT_PROPAGATE;
+
+    GT_ITEM_CONTAINER_GET_CLASS(self)->activate_child(self, tile);
+
+    return GDK_EVENT_STOP;
+}
+
+static void
+setup_grid(GtItemContainer* self)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkWidget* content = gtk_widget_get_parent(priv->item_flow);
+
+    priv->virtual_grid = TRUE;
+    priv->item_array = g_ptr_array_new_with_free_func(g_object_unref);
+    priv->tiles = g_ptr_array_new();
+    priv->pressed_index = -1;
+
+    /* NOTE: A window of its own so clicks between and on tiles reach us */
+    priv->item_grid = gtk_fixed_new();
+    gtk_widget_set_has_window(priv->item_grid, TRUE);
+    gtk_widget_add_events(priv->item_grid, GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK);
+    gtk_widget_set_hexpand(priv->item_grid, TRUE);
+    gtk_widget_show(priv->item_grid);
+
+    gtk_widget_destroy(priv->item_flow);
+    priv->item_flow = NULL;
+
+    gtk_box_pack_start(GTK_BOX(content), priv->item_grid, FALSE, FALSE, 0);
+    gtk_box_reorder_child(GTK_BOX(content), priv->item_grid, 0);
+
+    g_signal_connect(priv->item_grid, "size-allocate", G_CALLBACK(grid_size_allocate_cb), self);
+    g_signal_connect(priv->item_grid, "button-press-event", G_CALLBACK(grid_button_press_cb), self);
+    g_signal_connect(priv->item_grid, "button-release-event", G_CALLBACK(grid_button_release_cb), self);
+    g_signal_connect_swapped(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll)),
+        "value-changed", G_CALLBACK(layout_tiles), self);
+    g_signal_connect_swapped(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll)),
+        "changed", G_CALLBACK(layout_tiles), self);
+}
+
+static gboolean
+add_item(GtItemContainer* self, gpointer item)
+{
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkWidget* child = NULL;
+
+    //NOTE: Could've been added on its own while a fetch was in flight
+    if (g_hash_table_contains(priv->item_children, item))
+        return FALSE;
+
+    /* NOTE: The grid owns its items since tiles only hold on to the ones they show */
+    if (priv->virtual_grid)
+    {
+        g_ptr_array_add(priv->item_array, g_object_ref_sink(item));
+        g_hash_table_insert(priv->item_children, item, NULL);
+
+        priv->items = g_list_prepend(priv->items, item);
+        priv->num_items++;
+
+        layout_tiles(self);
+
+        return TRUE;
+    }
+
+    child = GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, item);
+
+    g_object_set_data(G_OBJECT(child), "item", item);
+
+    gtk_container_add(GTK_CONTAINER(priv->item_flow), child);
+
+    priv->items = g_list_prepend(priv->items, item);
+    g_hash_table_insert(priv->item_children, item, child);
+    priv->num_items++;
+
+    return TRUE;
+}
+
 static void
 fetch_items_cb(GObject* source,
     GAsyncResult* res, gpointer udata)
@@ -102,15 +548,12 @@ fetch_items_cb(GObject* source,
         return;
     }
 
-    priv->items = g_list_concat(priv->items, items);
-
     for (GList* l = items; l != NULL; l = l->next)
-    {
-        gtk_container_add(GTK_CONTAINER(priv->item_flow),
-            GT_ITEM_CONTAINER_GET_CLASS(self)->create_child(self, l->data));
+        add_item(self, l->data);
 
-        priv->num_items++;
-    }
+    g_list_free(items);
+
+    update_priorities(self);
 
     if (priv->num_items == 0)
         gtk_stack_set_visible_child(GTK_STACK(self), priv->empty_box);
@@ -305,14 +748,67 @@ constructed(GObject* obj)
         g_signal_connect(priv->item_scroll, "edge-reached", G_CALLBACK(edge_reached_cb), self);
     }
 
-    g_signal_connect(priv->item_flow, "child-activated", G_CALLBACK(child_activated_cb), self);
+    if (GT_ITEM_CONTAINER_GET_CLASS(self)->bind_child)
+        setup_grid(self);
+    else
+    {
+        g_signal_connect(priv->item_flow, "child-activated", G_CALLBACK(child_activated_cb), self);
+        g_signal_connect_swapped(priv->item_flow, "size-allocate", G_CALLBACK(update_priorities), self);
+    }
+
+    g_signal_connect_swapped(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(priv->item_scroll)),
+        "value-changed", G_CALLBACK(update_priorities), self);
+    g_signal_connect(self, "map", G_CALLBACK(update_priorities), NULL);
+    g_signal_connect(self, "unmap", G_CALLBACK(update_priorities), NULL);
+    g_signal_connect(self, "hierarchy-changed", G_CALLBACK(hierarchy_changed_cb), NULL);
+}
+
+static void
+dispose(GObject* obj)
+{
+    GtItemContainer* self = GT_ITEM_CONTAINER(obj);
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (priv->update_priorities_id > 0)
+    {
+        g_source_remove(priv->update_priorities_id);
+        priv->update_priorities_id = 0;
+    }
+
+    if (priv->layout_tiles_id > 0)
+    {
+        g_source_remove(priv->layout_tiles_id);
+        priv->layout_tiles_id = 0;
+    }
+
+    g_clear_pointer(&priv->item_children, g_hash_table_unref);
+    g_clear_pointer(&priv->item_array, g_ptr_array_unref);
+    g_clear_pointer(&priv->tiles, g_ptr_array_unref);
+
+    G_OBJECT_CLASS(gt_item_container_parent_class)->dispose(obj);
+}
+
+//NOTE: Covers the channel and game items all our containers show
+static void
+set_item_priority(GtItemContainer* self,
+    gpointer item, GtResourceDownloaderPriority priority)
+{
+    g_assert(GT_IS_ITEM_CONTAINER(self));
+
+    if (GT_IS_CHANNEL(item))
+        gt_channel_set_preview_priority(GT_CHANNEL(item), priority);
+    else if (GT_IS_GAME(item))
+        gt_game_set_preview_priority(GT_GAME(item), priority);
 }
 
 static void
 gt_item_container_class_init(GtItemContainerClass* klass)
 {
     klass->on_clear = NULL;
+    klass->set_item_priority = set_item_priority;
+    klass->bind_child = NULL;
 
+    G_OBJECT_CLASS(klass)->dispose = dispose;
     G_OBJECT_CLASS(klass)->set_property = set_property;
     G_OBJECT_CLASS(klass)->get_property = get_property;
     G_OBJECT_CLASS(klass)->constructed = constructed;
@@ -344,6 +840,7 @@ gt_item_container_init(GtItemContainer* self)
     GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
 
     priv->items = NULL;
+    priv->item_children = g_hash_table_new(g_direct_hash, g_direct_equal);
     priv->num_items = 0;
     priv->alloc = g_new(GdkRectangle, 1);
     priv->alloc->width = 0;
@@ -380,9 +877,74 @@ gt_item_container_refresh(GtItemContainer* self)
 
     g_list_free(priv->items); /* NOTE: We don't use free_full because the items are owned by the item_flow children */
     priv->items = NULL;
-    utils_container_clear(GTK_CONTAINER(priv->item_flow));
+    g_hash_table_remove_all(priv->item_children);
+
+    if (priv->virtual_grid)
+    {
+        g_ptr_array_set_size(priv->item_array, 0);
+        layout_tiles(self);
+    }
+    else
+        utils_container_clear(GTK_CONTAINER(priv->item_flow));
 
     priv->num_items = 0;
 
     fetch_items(self);
 }
+
+/* NOTE: Adds a single item without refetching the others, its child is
+ * put in place by the flow box's sort function if there is one */
+void
+gt_item_container_append_item(GtItemContainer* self, gpointer item)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+    RETURN_IF_FAIL(item != NULL);
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+
+    if (!add_item(self, item))
+        return;
+
+    if (gtk_stack_get_visible_child(GTK_STACK(self)) == priv->empty_box)
+        gtk_stack_set_visible_child(GTK_STACK(self), priv->item_scroll);
+
+    update_priorities(self);
+}
+
+void
+gt_item_container_remove_item(GtItemContainer* self, gpointer item)
+{
+    RETURN_IF_FAIL(GT_IS_ITEM_CONTAINER(self));
+    RETURN_IF_FAIL(item != NULL);
+
+    GtItemContainerPrivate* priv = gt_item_container_get_instance_private(self);
+    GtkWidget* child = g_hash_table_lookup(priv->item_children, item);
+    GList* found = NULL;
+
+    if (!g_hash_table_contains(priv->item_children, item))
+        return;
+
+    found = g_list_find(priv->items, item);
+
+    if (GT_ITEM_CONTAINER_GET_CLASS(self)->on_clear)
+    {
+        GList single = {item, NULL, NULL};
+
+        GT_ITEM_CONTAINER_GET_CLASS(self)->on_clear(self, &single);
+    }
+
+    priv->items = g_list_delete_link(priv->items, found);
+    g_hash_table_remove(priv->item_children, item);
+    priv->num_items--;
+
+    if (priv->virtual_grid)
+    {
+        g_ptr_array_remove(priv->item_array, item);
+        layout_tiles(self);
+    }
+    else
+        gtk_widget_destroy(child);
+
+    if (priv->num_items == 0 && !priv->fetching_items)
+        gtk_stack_set_visible_child(GTK_STACK(self), priv->empty_box);
+}
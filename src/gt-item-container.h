@@ -20,6 +20,7 @@
 #define GT_ITEM_CONTAINER_H
 
 #include <gtk/gtk.h>
+#include "gt-resource-downloader.h"
 
 G_BEGIN_DECLS
 
@@ -38,9 +39,18 @@ struct _GtItemContainerClass
     GTaskThreadFunc fetch_items;
     GtkWidget* (*create_child) (GtItemContainer* item_container, gpointer data);
     void (*activate_child) (GtItemContainer* item_container, gpointer child);
-    /* NOTE: This will be called before the container is cleared. This can be useful if you need
-     to do something like disconnect signals from each child. */
+    /* NOTE: This will be called before the container is cleared or items are removed. This can be
+     useful if you need to do something like disconnect signals from each child. */
     void (*on_clear) (GtItemContainer* item_container, GList* items);
+    /* NOTE: Called whenever an item's child moves in or out of the viewport so
+     its resources can be downloaded in the right order. Defaults to setting the
+     preview priority of GtChannel and GtGame items. Can be NULL. */
+    void (*set_item_priority) (GtItemContainer* item_container, gpointer item, GtResourceDownloaderPriority priority);
+    /* NOTE: Rebinds a child made by create_child to show another item. When set, the container keeps
+     only enough children to cover the viewport and reuses them while scrolling instead of making one
+     per item, which also means there's no flow box to sort or filter. Use
+     gt_channels_container_child_bind for channel children. Can be NULL. */
+    void (*bind_child) (GtItemContainer* item_container, GtkWidget* child, gpointer item);
 };
 
 typedef struct
@@ -49,8 +59,10 @@ typedef struct
     gint offset;
 } FetchItemsData;
 
-GtkWidget* gt_item_container_get_flow_box(GtItemContainer* self); /* NOTE: Should only be used by children*/
+GtkWidget* gt_item_container_get_flow_box(GtItemContainer* self); /* NOTE: Should only be used by children, NULL when bind_child is set */
 void gt_item_container_refresh(GtItemContainer* self);
+void gt_item_container_append_item(GtItemContainer* self, gpointer item);
+void gt_item_container_remove_item(GtItemContainer* self, gpointer item);
 
 G_END_DECLS;
 
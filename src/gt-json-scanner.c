@@ -0,0 +1,331 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-json-scanner.h"
+#include <gio/gio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define TAG "GtJsonScanner"
+#include "gnome-twitch/gt-log.h"
+
+#define SCANNER_ERROR(self, error, msg)                                 \
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,             \
+        "%s at offset %" G_GSIZE_FORMAT, msg, (gsize) (self->pos - self->start))
+
+void
+gt_json_scanner_init(GtJsonScanner* self, const gchar* data, gsize len)
+{
+    RETURN_IF_FAIL(self != NULL);
+    RETURN_IF_FAIL(data != NULL || len == 0);
+
+    self->start = data;
+    self->pos = data;
+    self->end = data + len;
+    self->value = g_string_sized_new(64);
+    self->member = g_string_sized_new(32);
+}
+
+void
+gt_json_scanner_clear(GtJsonScanner* self)
+{
+    RETURN_IF_FAIL(self != NULL);
+
+    if (self->value) g_string_free(self->value, TRUE);
+    if (self->member) g_string_free(self->member, TRUE);
+
+    self->value = NULL;
+    self->member = NULL;
+}
+
+static gboolean
+read_hex4(GtJsonScanner* self, gunichar* out)
+{
+    gunichar c = 0;
+
+    if (self->end - self->pos < 4)
+        return FALSE;
+
+    for (gint i = 0; i < 4; i++)
+    {
+        gint d = g_ascii_xdigit_value(*self->pos++);
+
+        if (d < 0)
+            return FALSE;
+
+        c = (c << 4) | d;
+    }
+
+    *out = c;
+
+    return TRUE;
+}
+
+static gboolean
+read_string(GtJsonScanner* self, GError** error)
+{
+    g_string_truncate(self->value, 0);
+
+    while (self->pos < self->end)
+    {
+        const gchar* start = self->pos;
+
+        /* NOTE: Copy plain runs in one go, most strings have no escapes */
+        while (self->pos < self->end && *self->pos != '"' && *self->pos != '\\')
+            self->pos++;
+
+        g_string_append_len(self->value, start, self->pos - start);
+
+        if (self->pos >= self->end)
+            break;
+
+        if (*self->pos++ == '"')
+            return TRUE;
+
+        if (self->pos >= self->end)
+            break;
+
+        switch (*self->pos++)
+        {
+            case '"':  g_string_append_c(self->value, '"'); break;
+            case '\\': g_string_append_c(self->value, '\\'); break;
+            case '/':  g_string_append_c(self->value, '/'); break;
+            case 'b':  g_string_append_c(self->value, '\b'); break;
+            case 'f':  g_string_append_c(self->value, '\f'); break;
+            case 'n':  g_string_append_c(self->value, '\n'); break;
+            case 'r':  g_string_append_c(self->value, '\r'); break;
+            case 't':  g_string_append_c(self->value, '\t'); break;
+            case 'u':
+            {
+                gunichar c;
+
+                if (!read_hex4(self, &c))
+                {
+                    SCANNER_ERROR(self, error, "Invalid unicode escape");
+                    return FALSE;
+                }
+
+                if (c >= 0xD800 && c <= 0xDBFF)
+                {
+                    gunichar low;
+
+                    if (self->end - self->pos < 2 || self->pos[0] != '\\' || self->pos[1] != 'u')
+                    {
+                        SCANNER_ERROR(self, error, "Unpaired surrogate");
+                        return FALSE;
+                    }
+
+                    self->pos += 2;
+
+                    if (!read_hex4(self, &low) || low < 0xDC00 || low > 0xDFFF)
+                    {
+                        SCANNER_ERROR(self, error, "Invalid surrogate pair");
+                        return FALSE;
+                    }
+
+                    c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                g_string_append_unichar(self->value, c);
+                break;
+            }
+            default:
+                SCANNER_ERROR(self, error, "Invalid escape sequence");
+                return FALSE;
+        }
+    }
+
+    SCANNER_ERROR(self, error, "Unterminated string");
+
+    return FALSE;
+}
+
+static gboolean
+read_literal(GtJsonScanner* self, const gchar* literal, gsize len)
+{
+    if ((gsize) (self->end - self->pos) < len || memcmp(self->pos, literal, len) != 0)
+        return FALSE;
+
+    self->pos += len;
+
+    return TRUE;
+}
+
+/* NOTE: Commas and colons are treated as whitespace, the structure is
+ * implied by the order the caller pulls tokens in. This is lenient on
+ * malformed input but Twitch only ever hands us valid documents. */
+GtJsonToken
+gt_json_scanner_next(GtJsonScanner* self, GError** error)
+{
+    RETURN_VAL_IF_FAIL(self != NULL, GT_JSON_TOKEN_INVALID);
+
+    while (self->pos < self->end &&
+        (g_ascii_isspace(*self->pos) || *self->pos == ',' || *self->pos == ':'))
+        self->pos++;
+
+    if (self->pos >= self->end)
+        return GT_JSON_TOKEN_END;
+
+    switch (*self->pos)
+    {
+        case '{': self->pos++; return GT_JSON_TOKEN_OBJECT_START;
+        case '}': self->pos++; return GT_JSON_TOKEN_OBJECT_END;
+        case '[': self->pos++; return GT_JSON_TOKEN_ARRAY_START;
+        case ']': self->pos++; return GT_JSON_TOKEN_ARRAY_END;
+        case '"':
+            self->pos++;
+            return read_string(self, error) ? GT_JSON_TOKEN_STRING : GT_JSON_TOKEN_INVALID;
+        case 't':
+            if (read_literal(self, "true", 4)) return GT_JSON_TOKEN_TRUE;
+            break;
+        case 'f':
+            if (read_literal(self, "false", 5)) return GT_JSON_TOKEN_FALSE;
+            break;
+        case 'n':
+            if (read_literal(self, "null", 4)) return GT_JSON_TOKEN_NULL;
+            break;
+        default:
+        {
+            const gchar* start = self->pos;
+
+            while (self->pos < self->end &&
+                (g_ascii_isdigit(*self->pos) || (*self->pos && strchr("+-.eE", *self->pos))))
+                self->pos++;
+
+            if (self->pos == start)
+                break;
+
+            g_string_truncate(self->value, 0);
+            g_string_append_len(self->value, start, self->pos - start);
+
+            return GT_JSON_TOKEN_NUMBER;
+        }
+    }
+
+    SCANNER_ERROR(self, error, "Unexpected character");
+
+    return GT_JSON_TOKEN_INVALID;
+}
+
+/* NOTE: Skips the value introduced by token, nested containers are
+ * walked by depth without keeping anything around */
+gboolean
+gt_json_scanner_skip(GtJsonScanner* self, GtJsonToken token, GError** error)
+{
+    gint depth = 0;
+
+    RETURN_VAL_IF_FAIL(self != NULL, FALSE);
+
+    do
+    {
+        switch (token)
+        {
+            case GT_JSON_TOKEN_OBJECT_START:
+            case GT_JSON_TOKEN_ARRAY_START:
+                depth++;
+                break;
+            case GT_JSON_TOKEN_OBJECT_END:
+            case GT_JSON_TOKEN_ARRAY_END:
+                depth--;
+                break;
+            case GT_JSON_TOKEN_INVALID:
+                return FALSE;
+            case GT_JSON_TOKEN_END:
+                SCANNER_ERROR(self, error, "Unexpected end of document");
+                return FALSE;
+            default:
+                break;
+        }
+
+        if (depth > 0)
+            token = gt_json_scanner_next(self, error);
+    } while (depth > 0);
+
+    return TRUE;
+}
+
+/* NOTE: Returns FALSE without setting an error once the object ends */
+gboolean
+gt_json_scanner_next_member(GtJsonScanner* self, const gchar** name, GError** error)
+{
+    GtJsonToken token;
+
+    RETURN_VAL_IF_FAIL(self != NULL, FALSE);
+
+    token = gt_json_scanner_next(self, error);
+
+    if (token == GT_JSON_TOKEN_OBJECT_END)
+        return FALSE;
+
+    if (token != GT_JSON_TOKEN_STRING)
+    {
+        if (token != GT_JSON_TOKEN_INVALID)
+            SCANNER_ERROR(self, error, "Expected member name");
+
+        return FALSE;
+    }
+
+    g_string_assign(self->member, self->value->str);
+
+    if (name)
+        *name = self->member->str;
+
+    return TRUE;
+}
+
+gboolean
+gt_json_scanner_expect(GtJsonScanner* self, GtJsonToken expected, GError** error)
+{
+    GtJsonToken token;
+
+    RETURN_VAL_IF_FAIL(self != NULL, FALSE);
+
+    token = gt_json_scanner_next(self, error);
+
+    if (token == expected)
+        return TRUE;
+
+    if (token != GT_JSON_TOKEN_INVALID)
+        SCANNER_ERROR(self, error, "Unexpected token");
+
+    return FALSE;
+}
+
+const gchar*
+gt_json_scanner_get_string(GtJsonScanner* self)
+{
+    RETURN_VAL_IF_FAIL(self != NULL, NULL);
+
+    return self->value->str;
+}
+
+gint64
+gt_json_scanner_get_int(GtJsonScanner* self)
+{
+    RETURN_VAL_IF_FAIL(self != NULL, 0);
+
+    return g_ascii_strtoll(self->value->str, NULL, 10);
+}
+
+gdouble
+gt_json_scanner_get_double(GtJsonScanner* self)
+{
+    RETURN_VAL_IF_FAIL(self != NULL, 0);
+
+    return g_ascii_strtod(self->value->str, NULL);
+}
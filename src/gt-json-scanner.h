@@ -0,0 +1,65 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_JSON_SCANNER_H
+#define GT_JSON_SCANNER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+    GT_JSON_TOKEN_INVALID,
+    GT_JSON_TOKEN_END,
+    GT_JSON_TOKEN_OBJECT_START,
+    GT_JSON_TOKEN_OBJECT_END,
+    GT_JSON_TOKEN_ARRAY_START,
+    GT_JSON_TOKEN_ARRAY_END,
+    GT_JSON_TOKEN_STRING,
+    GT_JSON_TOKEN_NUMBER,
+    GT_JSON_TOKEN_TRUE,
+    GT_JSON_TOKEN_FALSE,
+    GT_JSON_TOKEN_NULL,
+} GtJsonToken;
+
+/* NOTE: A pull scanner that walks a JSON document without building a
+ * tree. Meant to be allocated on the stack, the string returned for a
+ * token is only valid until the next call. */
+typedef struct
+{
+    const gchar* start;
+    const gchar* pos;
+    const gchar* end;
+    GString* value;
+    GString* member;
+} GtJsonScanner;
+
+void         gt_json_scanner_init(GtJsonScanner* self, const gchar* data, gsize len);
+void         gt_json_scanner_clear(GtJsonScanner* self);
+GtJsonToken  gt_json_scanner_next(GtJsonScanner* self, GError** error);
+gboolean     gt_json_scanner_skip(GtJsonScanner* self, GtJsonToken token, GError** error);
+gboolean     gt_json_scanner_next_member(GtJsonScanner* self, const gchar** name, GError** error);
+gboolean     gt_json_scanner_expect(GtJsonScanner* self, GtJsonToken expected, GError** error);
+const gchar* gt_json_scanner_get_string(GtJsonScanner* self);
+gint64       gt_json_scanner_get_int(GtJsonScanner* self);
+gdouble      gt_json_scanner_get_double(GtJsonScanner* self);
+
+G_END_DECLS
+
+#endif
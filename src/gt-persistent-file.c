@@ -0,0 +1,453 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-persistent-file.h"
+#include "utils.h"
+#include <glib/gstdio.h>
+#include <errno.h>
+
+#define TAG "GtPersistentFile"
+#include "gnome-twitch/gt-log.h"
+
+#define SAVE_DELAY 2 /* NOTE: In seconds */
+
+/* NOTE: Shared by the file and its queued writes, so the writer can
+ * outlive the file instead of the file waiting on the writer */
+typedef struct
+{
+    gint ref_count;
+
+    gchar* filepath;
+
+    GMutex mutex;
+    GCond cond;
+    guint64 queued;
+    guint64 written;
+} WriteState;
+
+typedef struct
+{
+    gchar* key;
+    gchar* json;
+} Entry;
+
+/* NOTE: The document is prefix, the entries joined by commas in the
+ * order they were first set and then suffix. Each entry is kept
+ * serialised so a change only costs serialising that entry, though
+ * every save still writes out the whole document. Writes go to a
+ * single worker so they land in order. */
+struct _GtPersistentFilePrivate
+{
+    gchar* prefix;
+    gchar* suffix;
+
+    GQueue entries; /* NOTE: Of Entry */
+    GHashTable* entry_index; /* NOTE: Key to its link in entries */
+
+    guint save_id;
+    GThreadPool* writer;
+    WriteState* state;
+};
+
+typedef struct
+{
+    WriteState* state;
+    gchar* contents; /* NOTE: NULL to remove the file */
+    gsize len;
+    GtPersistentFileBuildFunc build;
+    gpointer build_data;
+    GDestroyNotify build_data_destroy;
+    guint64 generation;
+} WriteJob;
+
+G_DEFINE_TYPE_WITH_PRIVATE(GtPersistentFile, gt_persistent_file, G_TYPE_OBJECT)
+
+GtPersistentFile*
+gt_persistent_file_new(const gchar* filepath, const gchar* prefix, const gchar* suffix)
+{
+    RETURN_VAL_IF_FAIL(!utils_str_empty(filepath), NULL);
+
+    GtPersistentFile* self = g_object_new(GT_TYPE_PERSISTENT_FILE, NULL);
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    priv->state->filepath = g_strdup(filepath);
+    priv->prefix = g_strdup(prefix ? prefix : "");
+    priv->suffix = g_strdup(suffix ? suffix : "");
+
+    return self;
+}
+
+static WriteState*
+write_state_ref(WriteState* state)
+{
+    g_atomic_int_inc(&state->ref_count);
+
+    return state;
+}
+
+static void
+write_state_unref(WriteState* state)
+{
+    if (!g_atomic_int_dec_and_test(&state->ref_count))
+        return;
+
+    g_free(state->filepath);
+    g_mutex_clear(&state->mutex);
+    g_cond_clear(&state->cond);
+
+    g_slice_free(WriteState, state);
+}
+
+static void
+write_job_cb(gpointer data, gpointer udata)
+{
+    WriteJob* job = data;
+    WriteState* state = job->state;
+    g_autoptr(GError) err = NULL;
+
+    if (job->build)
+    {
+        job->contents = job->build(job->build_data, &job->len);
+
+        if (job->build_data_destroy)
+            job->build_data_destroy(job->build_data);
+    }
+
+    //NOTE: Goes to a temporary file that's renamed over the old one
+    if (job->contents)
+        g_file_set_contents(state->filepath, job->contents, job->len, &err);
+    else if (g_remove(state->filepath) != 0 && errno != ENOENT)
+        g_set_error(&err, G_IO_ERROR, g_io_error_from_errno(errno), "%s", g_strerror(errno));
+
+    if (err)
+        WARNINGF("Unable to save file '%s' because: %s", state->filepath, err->message);
+    else
+        TRACEF("Saved file '%s'", state->filepath);
+
+    g_mutex_lock(&state->mutex);
+    state->written = MAX(state->written, job->generation);
+    g_cond_broadcast(&state->cond);
+    g_mutex_unlock(&state->mutex);
+
+    write_state_unref(state);
+    g_free(job->contents);
+    g_slice_free(WriteJob, job);
+}
+
+static void
+queue_write(GtPersistentFile* self, WriteJob* job)
+{
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    job->state = write_state_ref(priv->state);
+
+    g_mutex_lock(&priv->state->mutex);
+    job->generation = ++priv->state->queued;
+    g_mutex_unlock(&priv->state->mutex);
+
+    g_thread_pool_push(priv->writer, job, NULL);
+}
+
+static void
+entry_free(Entry* entry)
+{
+    g_free(entry->key);
+    g_free(entry->json);
+
+    g_slice_free(Entry, entry);
+}
+
+static void
+save(GtPersistentFile* self)
+{
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+    WriteJob* job = g_slice_new0(WriteJob);
+
+    if (!g_queue_is_empty(&priv->entries))
+    {
+        GString* contents = g_string_new(priv->prefix);
+
+        for (GList* l = priv->entries.head; l != NULL; l = l->next)
+        {
+            Entry* entry = l->data;
+
+            if (l != priv->entries.head)
+                g_string_append_c(contents, ',');
+
+            g_string_append(contents, entry->json);
+        }
+
+        g_string_append(contents, priv->suffix);
+
+        job->len = contents->len;
+        job->contents = g_string_free(contents, FALSE);
+    }
+
+    queue_write(self, job);
+}
+
+static gboolean
+save_cb(gpointer udata)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_PERSISTENT_FILE(udata), G_SOURCE_REMOVE);
+
+    GtPersistentFile* self = GT_PERSISTENT_FILE(udata);
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    priv->save_id = 0;
+
+    save(self);
+
+    return G_SOURCE_REMOVE;
+}
+
+//NOTE: Changes in quick succession end up in a single write
+static void
+schedule_save(GtPersistentFile* self)
+{
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    if (priv->save_id == 0)
+        priv->save_id = g_timeout_add_seconds(SAVE_DELAY, save_cb, self);
+}
+
+static void
+finalize(GObject* obj)
+{
+    GtPersistentFile* self = GT_PERSISTENT_FILE(obj);
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    if (priv->save_id > 0)
+        save_cb(self);
+
+    /* NOTE: The writer finishes what's queued on its own, waiting here
+     * would block for as long as the disk does. Use
+     * gt_persistent_file_flush to wait with a deadline. */
+    g_thread_pool_free(priv->writer, FALSE, FALSE);
+
+    write_state_unref(priv->state);
+    g_queue_foreach(&priv->entries, (GFunc) entry_free, NULL);
+    g_queue_clear(&priv->entries);
+    g_hash_table_unref(priv->entry_index);
+    g_free(priv->prefix);
+    g_free(priv->suffix);
+
+    G_OBJECT_CLASS(gt_persistent_file_parent_class)->finalize(obj);
+}
+
+static void
+gt_persistent_file_class_init(GtPersistentFileClass* klass)
+{
+    G_OBJECT_CLASS(klass)->finalize = finalize;
+}
+
+static void
+gt_persistent_file_init(GtPersistentFile* self)
+{
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    g_queue_init(&priv->entries);
+    priv->entry_index = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->writer = g_thread_pool_new(write_job_cb, NULL, 1, FALSE, NULL);
+
+    priv->state = g_slice_new0(WriteState);
+    priv->state->ref_count = 1;
+    g_mutex_init(&priv->state->mutex);
+    g_cond_init(&priv->state->cond);
+}
+
+void
+gt_persistent_file_set_node(GtPersistentFile* self, const gchar* key, JsonNode* node)
+{
+    RETURN_IF_FAIL(GT_IS_PERSISTENT_FILE(self));
+    RETURN_IF_FAIL(!utils_str_empty(key));
+    RETURN_IF_FAIL(node != NULL);
+
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+    GList* link = g_hash_table_lookup(priv->entry_index, key);
+    Entry* entry = NULL;
+
+    //NOTE: A changed entry keeps its place
+    if (link)
+    {
+        entry = link->data;
+        g_free(entry->json);
+    }
+    else
+    {
+        entry = g_slice_new0(Entry);
+        entry->key = g_strdup(key);
+
+        g_queue_push_tail(&priv->entries, entry);
+        g_hash_table_insert(priv->entry_index, entry->key, priv->entries.tail);
+    }
+
+    entry->json = json_to_string(node, FALSE);
+
+    schedule_save(self);
+}
+
+void
+gt_persistent_file_remove(GtPersistentFile* self, const gchar* key)
+{
+    RETURN_IF_FAIL(GT_IS_PERSISTENT_FILE(self));
+    RETURN_IF_FAIL(key != NULL);
+
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+    GList* link = g_hash_table_lookup(priv->entry_index, key);
+
+    if (!link)
+        return;
+
+    g_hash_table_remove(priv->entry_index, key);
+    entry_free(link->data);
+    g_queue_delete_link(&priv->entries, link);
+
+    schedule_save(self);
+}
+
+void
+gt_persistent_file_clear(GtPersistentFile* self)
+{
+    RETURN_IF_FAIL(GT_IS_PERSISTENT_FILE(self));
+
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    g_hash_table_remove_all(priv->entry_index);
+    g_queue_foreach(&priv->entries, (GFunc) entry_free, NULL);
+    g_queue_clear(&priv->entries);
+
+    schedule_save(self);
+}
+
+//NOTE: For after the entries were filled in from what's already on disk
+void
+gt_persistent_file_mark_saved(GtPersistentFile* self)
+{
+    RETURN_IF_FAIL(GT_IS_PERSISTENT_FILE(self));
+
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+
+    if (priv->save_id > 0)
+    {
+        g_source_remove(priv->save_id);
+        priv->save_id = 0;
+    }
+}
+
+/* NOTE: For documents that aren't a list of entries. Replaces the file
+ * with what build returns, or removes it on NULL. Build runs on the
+ * writer so the serialising stays off the main thread. */
+void
+gt_persistent_file_write_async(GtPersistentFile* self, GtPersistentFileBuildFunc build,
+    gpointer data, GDestroyNotify destroy)
+{
+    RETURN_IF_FAIL(GT_IS_PERSISTENT_FILE(self));
+    RETURN_IF_FAIL(build != NULL);
+
+    WriteJob* job = g_slice_new0(WriteJob);
+
+    job->build = build;
+    job->build_data = data;
+    job->build_data_destroy = destroy;
+
+    queue_write(self, job);
+}
+
+/* NOTE: Writes out any pending change and waits for the writer for at
+ * most timeout, returns whether everything made it to disk */
+gboolean
+gt_persistent_file_flush(GtPersistentFile* self, GTimeSpan timeout)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_PERSISTENT_FILE(self), FALSE);
+
+    GtPersistentFilePrivate* priv = gt_persistent_file_get_instance_private(self);
+    gint64 deadline = g_get_monotonic_time() + timeout;
+    gboolean ret = TRUE;
+
+    if (priv->save_id > 0)
+    {
+        g_source_remove(priv->save_id);
+        priv->save_id = 0;
+
+        save(self);
+    }
+
+    g_mutex_lock(&priv->state->mutex);
+
+    while (priv->state->written < priv->state->queued && ret)
+        ret = g_cond_wait_until(&priv->state->cond, &priv->state->mutex, deadline);
+
+    g_mutex_unlock(&priv->state->mutex);
+
+    if (!ret)
+        WARNINGF("Timed out saving file '%s'", priv->state->filepath);
+
+    return ret;
+}
+
+static void
+read_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    const gchar* filepath = task_data;
+    g_autoptr(JsonParser) parser = NULL;
+    GError* err = NULL;
+
+    if (!g_file_test(filepath, G_FILE_TEST_EXISTS))
+    {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+            "File '%s' does not exist", filepath);
+        return;
+    }
+
+    parser = json_parser_new();
+
+    if (!json_parser_load_from_file(parser, filepath, &err))
+    {
+        g_task_return_error(task, err);
+        return;
+    }
+
+    g_task_return_pointer(task, json_node_copy(json_parser_get_root(parser)),
+        (GDestroyNotify) json_node_unref);
+}
+
+/* NOTE: Reads and parses a JSON file on a worker thread */
+void
+gt_persistent_file_read_async(const gchar* filepath, GCancellable* cancel,
+    GAsyncReadyCallback cb, gpointer udata)
+{
+    RETURN_IF_FAIL(!utils_str_empty(filepath));
+
+    GTask* task = g_task_new(NULL, cancel, cb, udata);
+
+    g_task_set_task_data(task, g_strdup(filepath), g_free);
+
+    g_task_run_in_thread(task, read_cb);
+
+    g_object_unref(task);
+}
+
+JsonNode*
+gt_persistent_file_read_finish(GAsyncResult* result, GError** error)
+{
+    RETURN_VAL_IF_FAIL(G_IS_TASK(result), NULL);
+
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
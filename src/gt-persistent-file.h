@@ -0,0 +1,52 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_PERSISTENT_FILE_H
+#define GT_PERSISTENT_FILE_H
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+#define GT_TYPE_PERSISTENT_FILE (gt_persistent_file_get_type())
+
+G_DECLARE_FINAL_TYPE(GtPersistentFile, gt_persistent_file, GT, PERSISTENT_FILE, GObject);
+
+typedef struct _GtPersistentFilePrivate GtPersistentFilePrivate;
+
+typedef gchar* (*GtPersistentFileBuildFunc)(gpointer data, gsize* len);
+
+struct _GtPersistentFile
+{
+    GObject parent_instance;
+};
+
+GtPersistentFile* gt_persistent_file_new(const gchar* filepath, const gchar* prefix, const gchar* suffix);
+void              gt_persistent_file_set_node(GtPersistentFile* self, const gchar* key, JsonNode* node);
+void              gt_persistent_file_remove(GtPersistentFile* self, const gchar* key);
+void              gt_persistent_file_clear(GtPersistentFile* self);
+void              gt_persistent_file_mark_saved(GtPersistentFile* self);
+void              gt_persistent_file_write_async(GtPersistentFile* self, GtPersistentFileBuildFunc build, gpointer data, GDestroyNotify destroy);
+gboolean          gt_persistent_file_flush(GtPersistentFile* self, GTimeSpan timeout);
+void              gt_persistent_file_read_async(const gchar* filepath, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
+JsonNode*         gt_persistent_file_read_finish(GAsyncResult* result, GError** error);
+
+G_END_DECLS
+
+#endif
@@ -22,6 +22,7 @@
 #include "gt-app.h"
 #include "gt-enums.h"
 #include "gt-chat.h"
+#include "gt-persistent-file.h"
 #include "gnome-twitch/gt-player-backend.h"
 #include "utils.h"
 #include <libpeas-gtk/peas-gtk.h>
@@ -38,6 +39,7 @@
 
 #define CHANNEL_SETTINGS_FILE g_build_filename(g_get_user_data_dir(), "gnome-twitch", "channel_settings.json", NULL);
 #define CHANNEL_SETTINGS_FILE_VERSION 1
+#define CHANNEL_SETTINGS_FLUSH_TIMEOUT (G_TIME_SPAN_SECOND*2)
 
 typedef enum
 {
@@ -116,36 +118,76 @@ enum
 static GParamSpec* props[NUM_PROPS];
 
 static GHashTable* channel_settings_table;
+static GtPersistentFile* channel_settings_file;
 
 static void
-load_channel_settings()
+store_channel_settings(const gchar* id, GtPlayerChannelSettings* settings)
 {
-    g_autofree gchar* fp = CHANNEL_SETTINGS_FILE;
-    g_autoptr(JsonParser) parser = json_parser_new();
-    g_autoptr(JsonReader) reader = NULL;
-    g_autoptr(GError) err = NULL;
-    gint version = 0;
-    gint count = 0;
+    g_autoptr(JsonBuilder) builder = json_builder_new();
+    g_autoptr(JsonNode) node = NULL;
 
-    g_hash_table_remove_all(channel_settings_table);
+    json_builder_begin_object(builder);
 
-    MESSAGE("Loading chat settings");
+    json_builder_set_member_name(builder, "id");
+    json_builder_add_string_value(builder, id);
 
-    if (!g_file_test(fp, G_FILE_TEST_EXISTS))
-    {
-        INFO("Chat settings file at '%s' doesn't exist", fp);
-        return;
-    }
+    json_builder_set_member_name(builder, "dark-theme");
+    json_builder_add_boolean_value(builder, settings->dark_theme);
 
-    json_parser_load_from_file(parser, fp, &err);
+    json_builder_set_member_name(builder, "visible");
+    json_builder_add_boolean_value(builder, settings->visible);
 
-    if (err)
-    {
-        WARNING("Unable to load chat settings because: %s", err->message);
+    json_builder_set_member_name(builder, "docked");
+    json_builder_add_boolean_value(builder, settings->docked);
+
+    json_builder_set_member_name(builder, "opacity");
+    json_builder_add_double_value(builder, settings->opacity);
+
+    json_builder_set_member_name(builder, "width");
+    json_builder_add_double_value(builder, settings->width);
+
+    json_builder_set_member_name(builder, "height");
+    json_builder_add_double_value(builder, settings->height);
+
+    json_builder_set_member_name(builder, "x-pos");
+    json_builder_add_double_value(builder, settings->x_pos);
+
+    json_builder_set_member_name(builder, "y-pos");
+    json_builder_add_double_value(builder, settings->y_pos);
+
+    json_builder_set_member_name(builder, "docked-handle-pos");
+    json_builder_add_double_value(builder, settings->docked_handle_pos);
+
+    json_builder_end_object(builder);
+
+    node = json_builder_get_root(builder);
+
+    gt_persistent_file_set_node(channel_settings_file, id, node);
+}
+
+//NOTE: Only the changed channel is serialised again, the write is deferred
+static void
+channel_settings_changed(GtPlayer* self)
+{
+    GtPlayerPrivate* priv = gt_player_get_instance_private(self);
+
+    if (!priv->channel)
         return;
-    }
 
-    reader = json_reader_new(json_parser_get_root(parser));
+    store_channel_settings(gt_channel_get_id(priv->channel), priv->cur_channel_settings);
+}
+
+static void
+load_channel_settings(JsonNode* root)
+{
+    g_autoptr(JsonReader) reader = NULL;
+    gint version = 0;
+    gint count = 0;
+    gboolean changed = g_hash_table_size(channel_settings_table) > 0;
+
+    MESSAGE("Loading chat settings");
+
+    reader = json_reader_new(root);
 
 /* FIXME: Propagate errors to UI once GtApp implements a startup error queue */
 #define READ_JSON_VALUE(name, p)                                        \
@@ -214,89 +256,43 @@ load_channel_settings()
 
         json_reader_end_element(reader);
 
-        g_hash_table_insert(channel_settings_table, id, settings);
+        //NOTE: A channel opened before we finished loading keeps its settings
+        if (g_hash_table_contains(channel_settings_table, id))
+        {
+            gt_player_channel_settings_free(settings);
+            g_free(id);
+        }
+        else
+        {
+            store_channel_settings(id, settings);
+            g_hash_table_insert(channel_settings_table, id, settings);
+        }
     }
 
     if (version > 0) json_reader_end_member(reader);
 
+    //NOTE: Nothing new to write unless settings changed while we were loading
+    if (!changed)
+        gt_persistent_file_mark_saved(channel_settings_file);
+
 #undef READ_JSON_VALUE
 }
 
 static void
-save_channel_settings()
+read_channel_settings_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
 {
-    g_autofree gchar* fp = CHANNEL_SETTINGS_FILE;
-    g_autoptr(JsonBuilder) builder = json_builder_new();
-    g_autoptr(JsonGenerator) gen = json_generator_new();
-    g_autoptr(JsonNode) final = NULL;
     g_autoptr(GError) err = NULL;
-    GHashTableIter iter;
-    gchar* key;
-    GtPlayerChannelSettings* settings;
-
-    MESSAGE("Saving chat settings");
-
-    json_builder_begin_object(builder);
-
-    json_builder_set_member_name(builder, "version");
-    json_builder_add_int_value(builder, CHANNEL_SETTINGS_FILE_VERSION);
-
-    json_builder_set_member_name(builder, "chat-settings");
-    json_builder_begin_array(builder);
-
-    g_hash_table_iter_init(&iter, channel_settings_table);
-
-    while (g_hash_table_iter_next(&iter, (gpointer*) &key, (gpointer*) &settings))
-    {
-        json_builder_begin_object(builder);
-
-        json_builder_set_member_name(builder, "id");
-        json_builder_add_string_value(builder, key);
-
-        json_builder_set_member_name(builder, "dark-theme");
-        json_builder_add_boolean_value(builder, settings->dark_theme);
-
-        json_builder_set_member_name(builder, "visible");
-        json_builder_add_boolean_value(builder, settings->visible);
-
-        json_builder_set_member_name(builder, "docked");
-        json_builder_add_boolean_value(builder, settings->docked);
-
-        json_builder_set_member_name(builder, "opacity");
-        json_builder_add_double_value(builder, settings->opacity);
-
-        json_builder_set_member_name(builder, "width");
-        json_builder_add_double_value(builder, settings->width);
-
-        json_builder_set_member_name(builder, "height");
-        json_builder_add_double_value(builder, settings->height);
-
-        json_builder_set_member_name(builder, "x-pos");
-        json_builder_add_double_value(builder, settings->x_pos);
-
-        json_builder_set_member_name(builder, "y-pos");
-        json_builder_add_double_value(builder, settings->y_pos);
-
-        json_builder_set_member_name(builder, "docked-handle-pos");
-        json_builder_add_double_value(builder, settings->docked_handle_pos);
-
-        json_builder_end_object(builder);
-    }
-
-    json_builder_end_array(builder);
-
-    json_builder_end_object(builder);
-
-    final = json_builder_get_root(builder);
+    g_autoptr(JsonNode) root = NULL;
 
-    json_generator_set_root(gen, final);
-    json_generator_to_file(gen, fp, &err);
+    root = gt_persistent_file_read_finish(res, &err);
 
-    if (err)
-    {
-        WARNING("Unable to write chat settings file to '%s' because: %s",
-            fp, err->message);
-    }
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+        INFO("Chat settings file doesn't exist");
+    else if (err)
+        WARNING("Unable to load chat settings because: %s", err->message);
+    else
+        load_channel_settings(root);
 }
 
 static void
@@ -665,6 +661,8 @@ mouse_moved_cb(GtkWidget* widget,
         priv->cur_channel_settings->width = width_request / (gdouble) alloc.width;
         priv->cur_channel_settings->height = height_request / (gdouble) alloc.height;
 
+        channel_settings_changed(self);
+
         gtk_widget_queue_resize_no_redraw(priv->chat_view);
 
     }
@@ -751,7 +749,7 @@ app_shutdown_cb(GApplication* app,
 {
     g_assert_null(udata);
 
-    save_channel_settings();
+    gt_persistent_file_flush(channel_settings_file, CHANNEL_SETTINGS_FLUSH_TIMEOUT);
 }
 
 static void
@@ -779,22 +777,29 @@ set_property(GObject* obj,
         case PROP_CHANNEL:
             g_clear_object(&priv->channel);
             priv->channel = g_value_dup_object(val);
+            gt_twitch_stream_data_list_free(priv->stream_qualities);
+            priv->stream_qualities = NULL;
             break;
         case PROP_CHAT_DOCKED:
             priv->cur_channel_settings->docked = g_value_get_boolean(val);
             update_docked(self);
+            channel_settings_changed(self);
             break;
         case PROP_CHAT_OPACITY:
             priv->cur_channel_settings->opacity = g_value_get_double(val);
+            channel_settings_changed(self);
             break;
         case PROP_CHAT_VISIBLE:
             priv->cur_channel_settings->visible = g_value_get_boolean(val);
+            channel_settings_changed(self);
             break;
         case PROP_CHAT_DARK_THEME:
             priv->cur_channel_settings->dark_theme = g_value_get_boolean(val);
+            channel_settings_changed(self);
             break;
         case PROP_DOCKED_HANDLE_POSITION:
             priv->cur_channel_settings->docked_handle_pos = g_value_get_double(val);
+            channel_settings_changed(self);
             break;
         case PROP_EDIT_CHAT:
             priv->edit_chat = g_value_get_boolean(val);
@@ -858,6 +863,36 @@ get_property(GObject* obj,
     }
 }
 
+static void
+play_stream_quality(GtPlayer* self)
+{
+    GtPlayerPrivate* priv = gt_player_get_instance_private(self);
+    const GtTwitchStreamData* stream_data;
+
+    stream_data = gt_twitch_stream_list_filter_quality(priv->stream_qualities, priv->quality);
+
+    //NOTE: Incase we get back a different quality from what we asked for
+    //eg. when then quality doesn't exist, so we get the first one (normally source)
+    g_free(priv->quality);
+    priv->quality = g_strdup(stream_data->quality);
+    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_STREAM_QUALITY]);
+
+    g_object_set(self, "playing", FALSE, NULL);
+    g_object_set(priv->backend, "uri", stream_data->url, NULL);
+    g_object_set(self, "playing", TRUE, NULL);
+}
+
+static void
+start_stream(GtPlayer* self)
+{
+    GtPlayerPrivate* priv = gt_player_get_instance_private(self);
+
+    play_stream_quality(self);
+
+    priv->inhibitor_cookie = gtk_application_inhibit(GTK_APPLICATION(main_app),
+        GTK_WINDOW(GTK_WINDOW(GT_WIN_TOPLEVEL(self))), GTK_APPLICATION_INHIBIT_IDLE, "Playing a stream");
+}
+
 static void
 streams_list_cb(GObject* source,
                 GAsyncResult* res,
@@ -869,9 +904,10 @@ streams_list_cb(GObject* source,
 
     GtPlayer* self = GT_PLAYER(udata);
     GtPlayerPrivate* priv = gt_player_get_instance_private(self);
-    const GtTwitchStreamData* stream_data;
     g_autoptr(GError) err = NULL;
 
+    gt_twitch_stream_data_list_free(priv->stream_qualities);
+
     priv->stream_qualities = gt_twitch_all_streams_finish(GT_TWITCH(source), res, &err);
 
     if (err)
@@ -895,20 +931,7 @@ streams_list_cb(GObject* source,
         return;
     }
 
-    stream_data = gt_twitch_stream_list_filter_quality(priv->stream_qualities, priv->quality);
-
-    //NOTE: Incase we get back a different quality from what we asked for
-    //eg. when then quality doesn't exist, so we get the first one (normally source)
-    g_free(priv->quality);
-    priv->quality = g_strdup(stream_data->quality);
-    g_object_notify_by_pspec(G_OBJECT(self), props[PROP_STREAM_QUALITY]);
-
-    g_object_set(self, "playing", FALSE, NULL);
-    g_object_set(priv->backend, "uri", stream_data->url, NULL);
-    g_object_set(self, "playing", TRUE, NULL);
-
-    priv->inhibitor_cookie = gtk_application_inhibit(GTK_APPLICATION(main_app),
-        GTK_WINDOW(GTK_WINDOW(GT_WIN_TOPLEVEL(self))), GTK_APPLICATION_INHIBIT_IDLE, "Playing a stream");
+    start_stream(self);
 }
 
 static void
@@ -919,6 +942,11 @@ reload_button_cb(GtkButton* button,
 
     GtPlayerPrivate* priv = gt_player_get_instance_private(self);
 
+    //NOTE: Reloading is usually done because the stream broke, so
+    //don't replay the same variants from the cache
+    gt_twitch_forget_cached_streams(main_app->twitch,
+        gt_channel_get_name(priv->channel));
+
     //NOTE: Need to do this because of the way open_channel works
     //it will dereference channel before referencing it again
     gt_player_open_channel(self, g_object_ref(priv->channel));
@@ -1127,9 +1155,14 @@ gt_player_class_init(GtPlayerClass* klass)
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtPlayer, error_box);
     gtk_widget_class_bind_template_child_private(GTK_WIDGET_CLASS(klass), GtPlayer, reload_button);
 
+    g_autofree gchar* fp = CHANNEL_SETTINGS_FILE;
+    g_autofree gchar* prefix = g_strdup_printf("{\"version\":%d,\"chat-settings\":[",
+        CHANNEL_SETTINGS_FILE_VERSION);
+
     channel_settings_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) gt_player_channel_settings_free);
+    channel_settings_file = gt_persistent_file_new(fp, prefix, "]}");
 
-    load_channel_settings();
+    gt_persistent_file_read_async(fp, NULL, read_channel_settings_cb, NULL);
 }
 
 //Target -> source
@@ -1361,6 +1394,25 @@ gt_player_set_quality(GtPlayer* self, const gchar* quality)
 
     priv->quality = g_strdup(quality);
 
+    //NOTE: We already know the variants of this stream, switching is
+    //just a matter of pointing the backend somewhere else
+    if (priv->stream_qualities)
+    {
+        play_stream_quality(self);
+
+        return;
+    }
+
+    //NOTE: The playlist might have been prefetched, start right away if so
+    priv->stream_qualities = gt_twitch_cached_streams(main_app->twitch, name);
+
+    if (priv->stream_qualities)
+    {
+        start_stream(self);
+
+        return;
+    }
+
     gt_twitch_all_streams_async(main_app->twitch, name, NULL, (GAsyncReadyCallback) streams_list_cb, self);
 }
 
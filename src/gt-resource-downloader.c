@@ -6,27 +6,83 @@
 #define TAG "GtResourceDownloader"
 #include "gnome-twitch/gt-log.h"
 
+#define NUM_PRIORITIES (GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND + 1)
+#define MAX_CONNS_PER_HOST 6
+#define READ_BUFFER_SIZE 16384
+#define PROGRESS_INTERVAL (G_USEC_PER_SEC / 60)
+
+typedef struct
+{
+    gint ref_count;
+    GMutex mutex;
+    gboolean done;
+    GdkPixbuf* partial;
+    gint64 last_update;
+    GCancellable* cancel;
+    ResourceDownloaderProgressFunc cb;
+    gpointer udata;
+} ProgressData;
+
 typedef struct
 {
     gchar* filepath;
     gchar* image_filetype;
     SoupSession* soup;
-    GMutex mutex;
 } GtResourceDownloaderPrivate;
 
 typedef struct
 {
     gchar* uri;
     gchar* name;
+    gchar* host;
     ResourceDownloaderFunc cb;
     gpointer udata;
     GtResourceDownloader* self;
+    GCancellable* cancel;
+    gulong cancel_id; /* NOTE: Only connected while queued */
     SoupMessage* msg;
     GInputStream* istream;
+    ProgressData* progress;
+    gboolean return_cached;
 } ResourceData; /* FIXME: Better name? */
 
+typedef struct
+{
+    GWeakRef pixbuf;
+    gint64 timestamp;
+} SharedImage;
+
+typedef struct
+{
+    GMutex mutex;
+    GCond cond;
+    gboolean done;
+    GdkPixbuf* pixbuf;
+    GError* error;
+} BlockingData;
+
 static GThreadPool* dl_pool;
 
+/* NOTE: libsoup isn't thread safe, so messages are only ever sent
+ * from this thread and its context. The body streams it hands back are
+ * read and decoded on dl_pool workers, one worker per stream, which
+ * never call into the session themselves. */
+static GThread* dl_thread;
+static GMainContext* dl_context;
+
+/* NOTE: The queues and host counts are shared between all
+ * downloaders so the per host limit holds across all of them */
+static GQueue dl_queues[NUM_PRIORITIES];
+static GHashTable* dl_active_hosts;
+static guint dl_schedule_id;
+static GMutex dl_mutex;
+
+/* NOTE: Decoded images keyed by uri and size, shared between every
+ * object showing the same image. Entries only hold weak refs so they
+ * go away when the last user drops its image. */
+static GHashTable* shared_images;
+static GMutex shared_mutex;
+
 G_DEFINE_TYPE_WITH_PRIVATE(GtResourceDownloader, gt_resource_downloader, G_TYPE_OBJECT);
 
 static ResourceData*
@@ -35,6 +91,186 @@ resource_data_new()
     return g_slice_new0(ResourceData);
 }
 
+static void
+shared_image_free(SharedImage* image)
+{
+    g_weak_ref_clear(&image->pixbuf);
+
+    g_slice_free(SharedImage, image);
+}
+
+static void
+shared_image_finalized_cb(gpointer udata, GObject* obj)
+{
+    gchar* key = udata;
+    GdkPixbuf* current = NULL;
+
+    g_mutex_lock(&shared_mutex);
+
+    SharedImage* image = g_hash_table_lookup(shared_images, key);
+
+    /* NOTE: Don't evict the entry if it's been replaced by a newer image */
+    if (image && !(current = g_weak_ref_get(&image->pixbuf)))
+    {
+        TRACE("Evicting shared image with key '%s'", key);
+
+        g_hash_table_remove(shared_images, key);
+    }
+
+    g_mutex_unlock(&shared_mutex);
+
+    g_clear_object(&current);
+    g_free(key);
+}
+
+static ProgressData*
+progress_data_new(GCancellable* cancel,
+    ResourceDownloaderProgressFunc cb, gpointer udata)
+{
+    ProgressData* progress = g_slice_new0(ProgressData);
+
+    progress->ref_count = 1;
+    g_mutex_init(&progress->mutex);
+    progress->cancel = cancel ? g_object_ref(cancel) : NULL;
+    progress->cb = cb;
+    progress->udata = udata;
+
+    return progress;
+}
+
+static ProgressData*
+progress_data_ref(ProgressData* progress)
+{
+    g_atomic_int_inc(&progress->ref_count);
+
+    return progress;
+}
+
+static void
+progress_data_unref(ProgressData* progress)
+{
+    if (!progress || !g_atomic_int_dec_and_test(&progress->ref_count))
+        return;
+
+    g_mutex_clear(&progress->mutex);
+    g_clear_object(&progress->partial);
+    g_clear_object(&progress->cancel);
+
+    g_slice_free(ProgressData, progress);
+}
+
+static void
+progress_data_finish(ProgressData* progress)
+{
+    if (!progress) return;
+
+    /* NOTE: Waits for a running progress callback, none will run after this */
+    g_mutex_lock(&progress->mutex);
+
+    progress->done = TRUE;
+    g_clear_object(&progress->partial);
+
+    g_mutex_unlock(&progress->mutex);
+}
+
+static gboolean
+progress_idle_cb(gpointer udata)
+{
+    ProgressData* progress = udata;
+
+    g_mutex_lock(&progress->mutex);
+
+    if (progress->partial && !progress->done &&
+        !g_cancellable_is_cancelled(progress->cancel))
+    {
+        progress->cb(g_steal_pointer(&progress->partial), progress->udata);
+    }
+
+    g_clear_object(&progress->partial);
+
+    g_mutex_unlock(&progress->mutex);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+area_updated_cb(GdkPixbufLoader* loader,
+    gint x, gint y, gint width, gint height,
+    gpointer udata)
+{
+    ProgressData* progress = udata;
+    gint64 now = g_get_monotonic_time();
+    GdkPixbuf* pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+
+    /* NOTE: The UI can't show more than one partial image per frame anyway */
+    if (!pixbuf || now - progress->last_update < PROGRESS_INTERVAL)
+        return;
+
+    progress->last_update = now;
+
+    /* NOTE: The loader keeps writing into its pixbuf, so hand out a copy */
+    GdkPixbuf* partial = gdk_pixbuf_copy(pixbuf);
+
+    g_mutex_lock(&progress->mutex);
+
+    /* NOTE: Replace any partial image the main loop hasn't got to yet
+     * rather than queueing up another idle */
+    if (progress->partial)
+        g_object_unref(progress->partial);
+    else
+    {
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, progress_idle_cb,
+            progress_data_ref(progress), (GDestroyNotify) progress_data_unref);
+    }
+
+    progress->partial = partial;
+
+    g_mutex_unlock(&progress->mutex);
+}
+
+static GdkPixbuf*
+decode_stream(GInputStream* istream, GCancellable* cancel,
+    ProgressData* progress, GError** error)
+{
+    g_autoptr(GdkPixbufLoader) loader = gdk_pixbuf_loader_new();
+    guchar buf[READ_BUFFER_SIZE];
+    GError* err = NULL;
+    gssize len;
+
+    if (progress)
+        g_signal_connect(loader, "area-updated", G_CALLBACK(area_updated_cb), progress);
+
+    while ((len = g_input_stream_read(istream, buf, sizeof(buf), cancel, &err)) > 0)
+    {
+        if (!gdk_pixbuf_loader_write(loader, buf, len, &err))
+            break;
+    }
+
+    /* NOTE: The loader must always be closed, even on error */
+    if (err)
+    {
+        gdk_pixbuf_loader_close(loader, NULL);
+        g_propagate_error(error, err);
+
+        return NULL;
+    }
+
+    if (!gdk_pixbuf_loader_close(loader, error))
+        return NULL;
+
+    GdkPixbuf* ret = gdk_pixbuf_loader_get_pixbuf(loader);
+
+    if (!ret)
+    {
+        g_set_error(error, GDK_PIXBUF_ERROR, GDK_PIXBUF_ERROR_FAILED,
+            "Image stream ended before any image data was read");
+
+        return NULL;
+    }
+
+    return g_object_ref(ret);
+}
+
 static void
 resource_data_free(ResourceData* data)
 {
@@ -42,9 +278,12 @@ resource_data_free(ResourceData* data)
 
     g_free(data->uri);
     g_free(data->name);
+    g_free(data->host);
     g_object_unref(data->self);
-    g_object_unref(data->msg);
-    g_object_unref(data->istream);
+    g_clear_object(&data->cancel);
+    g_clear_object(&data->msg);
+    g_clear_object(&data->istream);
+    progress_data_unref(data->progress);
 
     g_slice_free(ResourceData, data);
 }
@@ -54,7 +293,8 @@ static GdkPixbuf*
 download_image(GtResourceDownloader* self,
     const gchar* uri, const gchar* name,
     SoupMessage* msg, GInputStream* istream,
-    gboolean* from_file, GError** error)
+    GCancellable* cancel, ProgressData* progress, gboolean* from_file,
+    GError** error)
 {
     RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
@@ -126,7 +366,7 @@ download_image(GtResourceDownloader* self,
         download:
             DEBUG("New image at uri '%s'", uri);
 
-            ret = gdk_pixbuf_new_from_stream(istream, NULL, &err);
+            ret = decode_stream(istream, cancel, progress, &err);
 
             if (err)
             {
@@ -157,6 +397,54 @@ download_image(GtResourceDownloader* self,
     return g_steal_pointer(&ret);
 }
 
+static gboolean schedule_downloads_cb(gpointer udata);
+
+/* NOTE: Must be called with dl_mutex held */
+static void
+schedule_downloads()
+{
+    if (dl_schedule_id == 0)
+    {
+        GSource* source = g_idle_source_new();
+
+        g_source_set_callback(source, schedule_downloads_cb, NULL, NULL);
+        dl_schedule_id = g_source_attach(source, dl_context);
+
+        g_source_unref(source);
+    }
+}
+
+static gpointer
+download_thread_cb(gpointer udata)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new(dl_context, FALSE);
+
+    g_main_context_push_thread_default(dl_context);
+
+    g_main_loop_run(loop);
+
+    g_main_context_pop_thread_default(dl_context);
+
+    return NULL;
+}
+
+static void
+release_host(ResourceData* data)
+{
+    g_mutex_lock(&dl_mutex);
+
+    guint active = GPOINTER_TO_UINT(g_hash_table_lookup(dl_active_hosts, data->host));
+
+    if (active > 1)
+        g_hash_table_insert(dl_active_hosts, g_strdup(data->host), GUINT_TO_POINTER(active - 1));
+    else
+        g_hash_table_remove(dl_active_hosts, data->host);
+
+    schedule_downloads();
+
+    g_mutex_unlock(&dl_mutex);
+}
+
 static void
 download_cb(ResourceData* data,
     gpointer udata)
@@ -168,9 +456,14 @@ download_cb(ResourceData* data,
     gboolean from_file = FALSE;
 
     ret = download_image(data->self, data->uri, data->name, data->msg,
-        data->istream, &from_file, &err);
+        data->istream, data->cancel, data->progress, &from_file, &err);
+
+    /* NOTE: The body has been read by now so the connection is free */
+    release_host(data);
+
+    progress_data_finish(data->progress);
 
-    data->cb(from_file ? NULL : g_steal_pointer(&ret),
+    data->cb(from_file && !data->return_cached ? NULL : g_steal_pointer(&ret),
         data->udata, g_steal_pointer(&err));
 
     resource_data_free(data);
@@ -185,8 +478,6 @@ send_message_cb(GObject* source,
     RETURN_IF_FAIL(udata != NULL);
 
     ResourceData* data = udata;
-    GtResourceDownloader* self = GT_RESOURCE_DOWNLOADER(data->self);
-    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
     g_autoptr(GError) err = NULL;
 
     data->istream = soup_session_send_finish(SOUP_SESSION(source), res, &err);
@@ -195,11 +486,85 @@ send_message_cb(GObject* source,
         g_thread_pool_push(dl_pool, data, NULL);
     else
     {
+        release_host(data);
+
         data->cb(NULL, data->udata, g_steal_pointer(&err));
         resource_data_free(data);
     }
 }
 
+static gboolean
+schedule_downloads_cb(gpointer udata)
+{
+    GList* ready = NULL;
+    GList* cancelled = NULL;
+
+    g_mutex_lock(&dl_mutex);
+
+    dl_schedule_id = 0;
+
+    for (gint i = 0; i < NUM_PRIORITIES; i++)
+    {
+        GList* l = dl_queues[i].head;
+
+        while (l != NULL)
+        {
+            ResourceData* data = l->data;
+            GList* next = l->next;
+            guint active = GPOINTER_TO_UINT(g_hash_table_lookup(dl_active_hosts, data->host));
+
+            if (g_cancellable_is_cancelled(data->cancel))
+            {
+                g_queue_delete_link(&dl_queues[i], l);
+                cancelled = g_list_prepend(cancelled, data);
+            }
+            else if (active < MAX_CONNS_PER_HOST)
+            {
+                g_queue_delete_link(&dl_queues[i], l);
+                g_hash_table_insert(dl_active_hosts, g_strdup(data->host), GUINT_TO_POINTER(active + 1));
+                ready = g_list_prepend(ready, data);
+            }
+
+            l = next;
+        }
+    }
+
+    g_mutex_unlock(&dl_mutex);
+
+    for (GList* l = cancelled; l != NULL; l = l->next)
+    {
+        ResourceData* data = l->data;
+        GError* err = NULL;
+
+        TRACE("Download from uri '%s' was cancelled while queued", data->uri);
+
+        g_cancellable_disconnect(data->cancel, data->cancel_id);
+
+        g_cancellable_set_error_if_cancelled(data->cancel, &err);
+
+        data->cb(NULL, data->udata, err);
+        resource_data_free(data);
+    }
+
+    ready = g_list_reverse(ready);
+
+    for (GList* l = ready; l != NULL; l = l->next)
+    {
+        ResourceData* data = l->data;
+        GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(data->self);
+
+        //NOTE: Out of the queue, soup handles the cancel from here on
+        g_cancellable_disconnect(data->cancel, data->cancel_id);
+
+        soup_session_send_async(priv->soup, data->msg, data->cancel, send_message_cb, data);
+    }
+
+    g_list_free(cancelled);
+    g_list_free(ready);
+
+    return G_SOURCE_REMOVE;
+}
+
 static void
 finalize(GObject* obj)
 {
@@ -235,6 +600,14 @@ gt_resource_downloader_class_init(GtResourceDownloaderClass* klass)
     G_OBJECT_CLASS(klass)->dispose = dispose;
 
     dl_pool = g_thread_pool_new((GFunc) download_cb, NULL, g_get_num_processors(), FALSE, NULL);
+
+    for (gint i = 0; i < NUM_PRIORITIES; i++)
+        g_queue_init(&dl_queues[i]);
+
+    dl_active_hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    dl_context = g_main_context_new();
+    dl_thread = g_thread_new("gt-resource-downloader", download_thread_cb, NULL);
 }
 
 static void
@@ -244,9 +617,11 @@ gt_resource_downloader_init(GtResourceDownloader* self)
 
     GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
 
-    priv->soup = soup_session_new();
-
-    g_mutex_init(&priv->mutex);
+    /* NOTE: The scheduler already limits connections per host,
+     * stop libsoup from queueing them again behind our backs */
+    priv->soup = soup_session_new_with_options(
+        SOUP_SESSION_MAX_CONNS_PER_HOST, MAX_CONNS_PER_HOST,
+        SOUP_SESSION_USE_THREAD_CONTEXT, TRUE, NULL);
 }
 
 GtResourceDownloader*
@@ -272,6 +647,90 @@ gt_resource_downloader_new_with_cache(const gchar* filepath)
     return ret;
 }
 
+//NOTE: Wake the scheduler so a cancelled download doesn't wait in the queue
+static void
+queued_download_cancelled_cb(GCancellable* cancel, gpointer udata)
+{
+    g_mutex_lock(&dl_mutex);
+
+    schedule_downloads();
+
+    g_mutex_unlock(&dl_mutex);
+}
+
+/* NOTE: The callback is called from one of the download threads */
+static void
+queue_download(GtResourceDownloader* self,
+    const gchar* uri, const gchar* name,
+    GtResourceDownloaderPriority priority, GCancellable* cancel,
+    gboolean return_cached, ResourceDownloaderProgressFunc progress_cb,
+    ResourceDownloaderFunc cb, gpointer udata)
+{
+    g_autoptr(SoupMessage) msg = NULL;
+    ResourceData* data = NULL;
+
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    if (!msg)
+    {
+        WARNING("Unable to download image because: Invalid uri '%s'", uri);
+
+        cb(NULL, udata, g_error_new(G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                "Unable to download image because: Invalid uri '%s'", uri));
+
+        return;
+    }
+
+    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
+
+    data = resource_data_new();
+    data->uri = g_strdup(uri);
+    data->name = g_strdup(name);
+    data->host = g_strdup(soup_uri_get_host(soup_message_get_uri(msg)));
+    data->cb = cb;
+    data->udata = udata;
+    data->self = g_object_ref(self);
+    data->cancel = cancel ? g_object_ref(cancel) : NULL;
+    data->msg = g_steal_pointer(&msg);
+    data->return_cached = return_cached;
+    data->progress = progress_cb ? progress_data_new(cancel, progress_cb, udata) : NULL;
+
+    /* NOTE: Connected before taking the lock, the callback runs right
+     * away if it's already cancelled */
+    if (data->cancel)
+    {
+        data->cancel_id = g_cancellable_connect(data->cancel,
+            G_CALLBACK(queued_download_cancelled_cb), NULL, NULL);
+    }
+
+    g_mutex_lock(&dl_mutex);
+
+    g_queue_push_tail(&dl_queues[priority], data);
+
+    schedule_downloads();
+
+    g_mutex_unlock(&dl_mutex);
+}
+
+static void
+download_image_blocking_cb(GdkPixbuf* pixbuf,
+    gpointer udata, GError* error)
+{
+    BlockingData* data = udata;
+
+    g_mutex_lock(&data->mutex);
+
+    data->pixbuf = pixbuf;
+    data->error = error;
+    data->done = TRUE;
+
+    g_cond_signal(&data->cond);
+
+    g_mutex_unlock(&data->mutex);
+}
+
+/* NOTE: Blocks until the download thread has finished with the
+ * image, don't call this from the main thread */
 GdkPixbuf*
 gt_resource_downloader_download_image(GtResourceDownloader* self,
     const gchar* uri, const gchar* name, GError** error)
@@ -279,61 +738,50 @@ gt_resource_downloader_download_image(GtResourceDownloader* self,
     RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
 
-    GtResourceDownloaderPrivate* priv = gt_resource_downloader_get_instance_private(self);
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(GInputStream) istream = NULL;
-    g_autoptr(GdkPixbuf) ret = NULL;
-    g_autoptr(GError) err = NULL;
+    BlockingData data = {0};
 
     DEBUG("Downloading image from uri '%s'", uri);
 
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
+    g_mutex_init(&data.mutex);
+    g_cond_init(&data.cond);
 
-    /* NOTE: So libsoup isn't actually all that thread safe and
-     * calling soup_session_send from multiple threads causes it to
-     * crash, so we wrap a mutex around it. One should use the
-     * download_image_immediately func if one wants to download
-     * several images at the same time */
-    g_mutex_lock(&priv->mutex);
-    istream = soup_session_send(priv->soup, msg, NULL, &err);
-    g_mutex_unlock(&priv->mutex);
+    queue_download(self, uri, name, GT_RESOURCE_DOWNLOADER_PRIORITY_VISIBLE,
+        NULL, TRUE, NULL, download_image_blocking_cb, &data);
 
-    if (err)
+    g_mutex_lock(&data.mutex);
+
+    while (!data.done)
+        g_cond_wait(&data.cond, &data.mutex);
+
+    g_mutex_unlock(&data.mutex);
+
+    g_mutex_clear(&data.mutex);
+    g_cond_clear(&data.cond);
+
+    if (data.error)
     {
         WARNING("Unable to download image from uri '%s' because: %s",
-            uri, err->message);
+            uri, data.error->message);
 
-        g_propagate_prefixed_error(error, g_steal_pointer(&err),
+        g_propagate_prefixed_error(error, data.error,
             "Unable to download image from uri '%s' because: ", uri);
-
-        return NULL;
     }
 
-    ret = download_image(self, uri, name, msg, istream, NULL, error);
-
-    return g_steal_pointer(&ret);
+    return data.pixbuf;
 }
 
-
 static void
-download_image_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
+download_image_async_cb(GdkPixbuf* pixbuf,
+    gpointer udata, GError* error)
 {
-    RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(source));
-    RETURN_IF_FAIL(G_IS_TASK(task));
-    RETURN_IF_FAIL(task_data != NULL);
-
-    GtResourceDownloader* self = GT_RESOURCE_DOWNLOADER(source);
-    GError* err = NULL;
-    GenericTaskData* data = task_data;
+    RETURN_IF_FAIL(G_IS_TASK(udata));
 
-    GdkPixbuf* ret = gt_resource_downloader_download_image(self,
-        data->str_1, data->str_2, &err);
+    g_autoptr(GTask) task = udata;
 
-    if (err)
-        g_task_return_error(task, err);
+    if (error)
+        g_task_return_error(task, error);
     else
-        g_task_return_pointer(task, ret, (GDestroyNotify) g_object_unref);
+        g_task_return_pointer(task, pixbuf, (GDestroyNotify) g_object_unref);
 }
 
 void
@@ -342,16 +790,12 @@ gt_resource_downloader_download_image_async(GtResourceDownloader* self,
     GCancellable* cancel, gpointer udata)
 {
     RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self));
+    RETURN_IF_FAIL(!utils_str_empty(uri));
 
-    g_autoptr(GTask) task = g_task_new(self, cancel, cb, udata);
-    GenericTaskData* data = generic_task_data_new();
+    GTask* task = g_task_new(self, cancel, cb, udata);
 
-    data->str_1 = g_strdup(uri);
-    data->str_2 = g_strdup(name);
-
-    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
-
-    g_task_run_in_thread(task, download_image_async_cb);
+    queue_download(self, uri, name, GT_RESOURCE_DOWNLOADER_PRIORITY_VISIBLE,
+        cancel, TRUE, NULL, download_image_async_cb, task);
 }
 
 GdkPixbuf*
@@ -377,11 +821,11 @@ gt_resource_downloader_set_image_filetype(GtResourceDownloader* self, const gcha
     priv->image_filetype = g_strdup(image_filetype);
 }
 
-/* FIXME: Make cancellable */
-GdkPixbuf*
-gt_resource_downloader_download_image_immediately(GtResourceDownloader* self,
-    const gchar* uri, const gchar* name, ResourceDownloaderFunc cb,
-    gpointer udata, GError** error)
+static GdkPixbuf*
+download_image_immediately(GtResourceDownloader* self,
+    const gchar* uri, const gchar* name, GtResourceDownloaderPriority priority,
+    GCancellable* cancel, ResourceDownloaderProgressFunc progress_cb,
+    ResourceDownloaderFunc cb, gpointer udata, GError** error)
 {
     RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
     RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
@@ -390,8 +834,6 @@ gt_resource_downloader_download_image_immediately(GtResourceDownloader* self,
     g_autofree gchar* filename = NULL;
     g_autoptr(GdkPixbuf) ret = NULL;
     g_autoptr(GError) err = NULL;
-    g_autoptr(SoupMessage) msg = NULL;
-    ResourceData* data = NULL;
 
     /* NOTE: If we aren't supplied a filename, we'll just create one by hashing the uri */
     if (utils_str_empty(name))
@@ -424,19 +866,128 @@ gt_resource_downloader_download_image_immediately(GtResourceDownloader* self,
         }
     }
 
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
-    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
-
-    data = resource_data_new();
-    data->uri = g_strdup(uri);
-    data->name = g_strdup(name);
-    data->cb = cb;
-    data->udata = udata;
-    data->self = g_object_ref(self);
-    data->msg = g_steal_pointer(&msg);
-
-    soup_session_send_async(priv->soup, data->msg, NULL, send_message_cb, data);
+    queue_download(self, uri, name, priority, cancel, FALSE, progress_cb, cb, udata);
 
     /* NOTE: Return any found image immediately */
     return g_steal_pointer(&ret);
 }
+
+/* NOTE: The callback is always called exactly once, either with the
+ * downloaded image, with an error or with G_IO_ERROR_CANCELLED */
+GdkPixbuf*
+gt_resource_downloader_download_image_immediately(GtResourceDownloader* self,
+    const gchar* uri, const gchar* name, GtResourceDownloaderPriority priority,
+    GCancellable* cancel, ResourceDownloaderFunc cb, gpointer udata, GError** error)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
+
+    return download_image_immediately(self, uri, name, priority,
+        cancel, NULL, cb, udata, error);
+}
+
+/* NOTE: Same as above, but while the image is still arriving partially
+ * decoded copies of it are also passed to the progress callback. It's
+ * called from the main thread, at most once per frame and never after
+ * the final callback has started. */
+GdkPixbuf*
+gt_resource_downloader_download_image_progressive(GtResourceDownloader* self,
+    const gchar* uri, const gchar* name, GtResourceDownloaderPriority priority,
+    GCancellable* cancel, ResourceDownloaderProgressFunc progress_cb,
+    ResourceDownloaderFunc cb, gpointer udata, GError** error)
+{
+    RETURN_VAL_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self), NULL);
+    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
+    RETURN_VAL_IF_FAIL(progress_cb != NULL, NULL);
+
+    return download_image_immediately(self, uri, name, priority,
+        cancel, progress_cb, cb, udata, error);
+}
+
+void
+gt_resource_downloader_set_priority(GtResourceDownloader* self,
+    GCancellable* cancel, GtResourceDownloaderPriority priority)
+{
+    RETURN_IF_FAIL(GT_IS_RESOURCE_DOWNLOADER(self));
+    RETURN_IF_FAIL(G_IS_CANCELLABLE(cancel));
+    RETURN_IF_FAIL(priority < NUM_PRIORITIES);
+
+    g_mutex_lock(&dl_mutex);
+
+    for (gint i = 0; i < NUM_PRIORITIES; i++)
+    {
+        GList* l = dl_queues[i].head;
+
+        if (i == priority)
+            continue;
+
+        while (l != NULL)
+        {
+            ResourceData* data = l->data;
+            GList* next = l->next;
+
+            if (data->self == self && data->cancel == cancel)
+            {
+                g_queue_unlink(&dl_queues[i], l);
+                g_queue_push_tail_link(&dl_queues[priority], l);
+            }
+
+            l = next;
+        }
+    }
+
+    g_mutex_unlock(&dl_mutex);
+}
+
+GdkPixbuf*
+gt_resource_downloader_lookup_shared_image(const gchar* uri,
+    gint width, gint height, GTimeSpan max_age)
+{
+    RETURN_VAL_IF_FAIL(!utils_str_empty(uri), NULL);
+
+    g_autofree gchar* key = g_strdup_printf("%s@%dx%d", uri, width, height);
+    GdkPixbuf* ret = NULL;
+
+    g_mutex_lock(&shared_mutex);
+
+    SharedImage* image = shared_images ? g_hash_table_lookup(shared_images, key) : NULL;
+
+    /* NOTE: A negative max age means the image never goes stale */
+    if (image && (max_age < 0 || g_get_monotonic_time() - image->timestamp <= max_age))
+        ret = g_weak_ref_get(&image->pixbuf);
+
+    g_mutex_unlock(&shared_mutex);
+
+    DEBUG("Shared image with key '%s' %s", key, ret ? "hit" : "missed");
+
+    return ret;
+}
+
+void
+gt_resource_downloader_share_image(const gchar* uri,
+    gint width, gint height, GdkPixbuf* pixbuf)
+{
+    RETURN_IF_FAIL(!utils_str_empty(uri));
+    RETURN_IF_FAIL(GDK_IS_PIXBUF(pixbuf));
+
+    gchar* key = g_strdup_printf("%s@%dx%d", uri, width, height);
+    SharedImage* image = g_slice_new0(SharedImage);
+
+    g_weak_ref_init(&image->pixbuf, pixbuf);
+    image->timestamp = g_get_monotonic_time();
+
+    g_mutex_lock(&shared_mutex);
+
+    if (!shared_images)
+    {
+        shared_images = g_hash_table_new_full(g_str_hash, g_str_equal,
+            g_free, (GDestroyNotify) shared_image_free);
+    }
+
+    g_hash_table_insert(shared_images, g_strdup(key), image);
+
+    g_mutex_unlock(&shared_mutex);
+
+    /* NOTE: Takes ownership of the key */
+    g_object_weak_ref(G_OBJECT(pixbuf), shared_image_finalized_cb, key);
+}
@@ -12,6 +12,15 @@ G_BEGIN_DECLS
 #define GT_IMAGE_FILETYPE_PNG "png"
 
 typedef void (*ResourceDownloaderFunc)(GdkPixbuf* pixbuf, gpointer udata, GError* err);
+typedef void (*ResourceDownloaderProgressFunc)(GdkPixbuf* partial, gpointer udata);
+
+/* NOTE: Order matters, lower values are sent first */
+typedef enum
+{
+    GT_RESOURCE_DOWNLOADER_PRIORITY_VISIBLE,
+    GT_RESOURCE_DOWNLOADER_PRIORITY_NEAR_VISIBLE,
+    GT_RESOURCE_DOWNLOADER_PRIORITY_BACKGROUND,
+} GtResourceDownloaderPriority;
 
 G_DECLARE_FINAL_TYPE(GtResourceDownloader, gt_resource_downloader, GT, RESOURCE_DOWNLOADER, GObject);
 
@@ -26,7 +35,11 @@ void                  gt_resource_downloader_set_image_filetype(GtResourceDownlo
 GdkPixbuf*            gt_resource_downloader_download_image(GtResourceDownloader* self, const gchar* uri, const gchar* name, GError** error);
 void                  gt_resource_downloader_download_image_async(GtResourceDownloader* self, const gchar* uri, const gchar* name, GAsyncReadyCallback cb, GCancellable* cancel, gpointer udata);
 GdkPixbuf*            gt_resource_donwloader_download_image_finish(GtResourceDownloader* self, GAsyncResult* result, GError** error);
-GdkPixbuf*            gt_resource_downloader_download_image_immediately(GtResourceDownloader* self, const gchar* uri, const gchar* name, ResourceDownloaderFunc cb, gpointer udata, GError** error);
+GdkPixbuf*            gt_resource_downloader_download_image_immediately(GtResourceDownloader* self, const gchar* uri, const gchar* name, GtResourceDownloaderPriority priority, GCancellable* cancel, ResourceDownloaderFunc cb, gpointer udata, GError** error);
+GdkPixbuf*            gt_resource_downloader_download_image_progressive(GtResourceDownloader* self, const gchar* uri, const gchar* name, GtResourceDownloaderPriority priority, GCancellable* cancel, ResourceDownloaderProgressFunc progress_cb, ResourceDownloaderFunc cb, gpointer udata, GError** error);
+void                  gt_resource_downloader_set_priority(GtResourceDownloader* self, GCancellable* cancel, GtResourceDownloaderPriority priority);
+GdkPixbuf*            gt_resource_downloader_lookup_shared_image(const gchar* uri, gint width, gint height, GTimeSpan max_age);
+void                  gt_resource_downloader_share_image(const gchar* uri, gint width, gint height, GdkPixbuf* pixbuf);
 
 G_END_DECLS
 
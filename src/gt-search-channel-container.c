@@ -228,6 +228,7 @@ gt_search_channel_container_class_init(GtSearchChannelContainerClass* klass)
     G_OBJECT_CLASS(klass)->set_property = set_property;
 
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = gt_channels_container_child_bind;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->fetch_items = fetch_items;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
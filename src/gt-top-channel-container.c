@@ -96,6 +96,7 @@ static void
 gt_top_channel_container_class_init(GtTopChannelContainerClass* klass)
 {
     GT_ITEM_CONTAINER_CLASS(klass)->create_child = create_child;
+    GT_ITEM_CONTAINER_CLASS(klass)->bind_child = gt_channels_container_child_bind;
     GT_ITEM_CONTAINER_CLASS(klass)->get_properties = get_properties;
     GT_ITEM_CONTAINER_CLASS(klass)->fetch_items = fetch_items;
     GT_ITEM_CONTAINER_CLASS(klass)->activate_child = activate_child;
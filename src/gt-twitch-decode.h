@@ -0,0 +1,40 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GT_TWITCH_DECODE_H
+#define GT_TWITCH_DECODE_H
+
+#include <json-glib/json-glib.h>
+#include "gt-json-scanner.h"
+#include "gt-channel.h"
+#include "gt-game.h"
+
+G_BEGIN_DECLS
+
+/* NOTE: The stream and game decoders GtTwitch builds its replies with,
+ * exposed so the tests and benchmarks can run them on recorded responses.
+ * The decode functions expect the object to have been opened already. */
+
+GtChannelData* gt_twitch_parse_stream(JsonReader* reader, GError** error);
+GtGameData*    gt_twitch_parse_game(JsonReader* reader, GError** error);
+GtChannelData* gt_twitch_decode_stream(GtJsonScanner* scanner, GError** error);
+GtGameData*    gt_twitch_decode_game(GtJsonScanner* scanner, GError** error);
+
+G_END_DECLS
+
+#endif
@@ -18,6 +18,8 @@
 
 #include "gt-twitch.h"
 #include "gt-resource-downloader.h"
+#include "gt-json-scanner.h"
+#include "gt-twitch-decode.h"
 #include "config.h"
 #include <libsoup/soup.h>
 #include <glib/gprintf.h>
@@ -43,6 +45,7 @@
 #define SEARCH_GAMES_URI       "https://api.twitch.tv/kraken/search/games?query=%s&type=suggest"
 #define FETCH_STREAM_URI       "https://api.twitch.tv/kraken/streams/%s"
 #define FETCH_CHANNEL_URI      "https://api.twitch.tv/kraken/channels/%s"
+#define LIVE_STREAMS_URI       "https://api.twitch.tv/kraken/streams?channel=%s&limit=%d&stream_type=live"
 #define CHAT_BADGES_URI        "https://api.twitch.tv/kraken/chat/%s/badges/"
 #define TWITCH_EMOTE_URI       "https://static-cdn.jtvnw.net/emoticons/v1/%d/%d.0"
 #define CHANNEL_INFO_URI       "http://api.twitch.tv/api/channels/%s/panels"
@@ -59,11 +62,26 @@
 #define OAUTH_INFO_URI         "https://api.twitch.tv/kraken/?oauth_token=%s"
 
 #define STREAM_INFO "#EXT-X-STREAM-INF"
+#define PLAYLIST_EXPIRY_MARGIN 60 /* NOTE: In seconds */
+#define PLAYLIST_DEFAULT_LIFETIME 300
+#define PREFETCH_BUDGET 6
+#define PREFETCH_WINDOW G_TIME_SPAN_MINUTE
 
 #define TWITCH_API_VERSION_3 "3"
 #define TWITCH_API_VERSION_4 "4"
 #define TWITCH_API_VERSION_5 "5"
 
+#define MAX_CONNS 16
+#define MAX_CONNS_PER_HOST 6
+#define MAX_PARSE_THREADS 2
+#define MAX_REQUEST_THREADS 4
+#define MAX_CACHE_ENTRIES 256
+#define MAX_LIVE_STREAMS_IDS 100
+#define MAX_RETRIES 3
+#define RETRY_BACKOFF G_USEC_PER_SEC
+#define MAX_RETRY_BACKOFF (G_USEC_PER_SEC*60)
+#define GOVERNED_HOST "api.twitch.tv"
+
 #define END_JSON_MEMBER() json_reader_end_member(reader) // Just for consistency's sake
 #define END_JSON_ELEMENT() json_reader_end_element(reader) // Just for consistency's sake
 
@@ -180,6 +198,75 @@
         goto error;                                                     \
     }                                                                   \
 
+/* NOTE: Lower priorities keep a bigger share of the rate limit in
+ * reserve and are only sent once nothing above them is waiting */
+typedef enum
+{
+    REQUEST_PRIORITY_HIGH, //NOTE: Something the user is waiting on
+    REQUEST_PRIORITY_NORMAL, //NOTE: Prefetching
+    REQUEST_PRIORITY_LOW, //NOTE: Background refreshing
+    NUM_REQUEST_PRIORITIES,
+} RequestPriority;
+
+typedef gpointer (*ParseJsonFunc)(GtTwitch* self, JsonReader* reader, GenericTaskData* params, GError** error);
+typedef gpointer (*DecodeJsonFunc)(GtTwitch* self, GtJsonScanner* scanner, GenericTaskData* params, GError** error);
+
+typedef struct
+{
+    gint ref_count;
+    GMutex mutex;
+    GCond cond;
+    gboolean done;
+    GBytes* body;
+    JsonNode* root;
+    GError* error;
+    GList* followers;
+} Flight;
+
+typedef struct
+{
+    GTask* task;
+    SoupMessage* msg;
+    GBytes* body;
+    JsonNode* root;
+    gchar* cache_key;
+    Flight* flight;
+    ParseJsonFunc parse;
+    DecodeJsonFunc decode;
+    GDestroyNotify result_free;
+    gint attempts;
+} RequestData;
+
+typedef struct
+{
+    const gchar* path;
+    GTimeSpan ttl;
+    GTimeSpan max_stale;
+} CachePolicy;
+
+typedef struct
+{
+    GBytes* body;
+    gint64 timestamp;
+    const CachePolicy* policy;
+    gboolean revalidating;
+} CacheEntry;
+
+typedef struct
+{
+    GTask* task;
+    GTaskThreadFunc func;
+} RequestThreadData;
+
+typedef struct
+{
+    GtTwitchStreamAccessToken* token;
+    gint64 expires;
+    GList* streams;
+    gint64 fetch_time; /* NOTE: How long fetching took, in microseconds */
+    gboolean prefetched;
+} PlaylistCacheEntry;
+
 typedef struct
 {
     SoupSession* soup;
@@ -188,6 +275,13 @@ typedef struct
 
     GHashTable* emote_table;
     GHashTable* badge_table;
+
+    /* NOTE: Parsed channel search pages for the current query only */
+    GMutex search_mutex;
+    gchar* search_query;
+    gboolean search_offline;
+    GHashTable* search_pages;
+    gint search_prefetch_page;
 } GtTwitchPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GtTwitch, gt_twitch,  G_TYPE_OBJECT)
@@ -195,6 +289,67 @@ G_DEFINE_TYPE_WITH_PRIVATE(GtTwitch, gt_twitch,  G_TYPE_OBJECT)
 static GtResourceDownloader* emote_downloader;
 static GtResourceDownloader* badge_downloader;
 
+/* NOTE: Responses are parsed here so large ones don't stall the UI */
+static GThreadPool* parse_pool;
+
+/* NOTE: Requests that need several round trips still block a thread
+ * while they run, so keep them out of GLib's shared GTask pool */
+static GThreadPool* request_pool;
+
+/* NOTE: How long responses from each endpoint are fresh and how long
+ * after that they're still served while being refetched in the
+ * background. Paths are matched with g_pattern_match_simple. These are
+ * the defaults, the response-cache-ttls setting can override them. */
+static const CachePolicy default_cache_policies[] =
+{
+    {"/kraken/games/top", 2*G_TIME_SPAN_MINUTE, 30*G_TIME_SPAN_MINUTE},
+    {"/kraken/streams", 30*G_TIME_SPAN_SECOND, 10*G_TIME_SPAN_MINUTE},
+    {"/kraken/search/games", 10*G_TIME_SPAN_MINUTE, G_TIME_SPAN_HOUR},
+    /* NOTE: Channels are polled for their state, never serve these stale */
+    {"/kraken/streams/*", 20*G_TIME_SPAN_SECOND, 0},
+    {"/kraken/channels/*", 5*G_TIME_SPAN_MINUTE, 0},
+};
+
+static CachePolicy cache_policies[G_N_ELEMENTS(default_cache_policies)];
+
+static GHashTable* cache_table;
+static GMutex cache_mutex;
+
+/* NOTE: Identical requests that are already in flight, anyone asking
+ * for the same thing waits for the first one instead */
+static GHashTable* flight_table;
+static GMutex flight_mutex;
+static gint flights_sent;
+static gint flights_coalesced;
+
+/* NOTE: Access tokens and the variants of the playlists they unlocked,
+ * keyed by channel name. Switching quality or reloading a stream
+ * picks from these until the token expires. */
+static GHashTable* playlist_cache;
+static GMutex playlist_mutex;
+
+/* NOTE: Channels the user looks like they're about to open get their
+ * playlists fetched ahead of time, a few per minute at most */
+static GHashTable* prefetch_pending;
+static gint64 prefetch_window_start;
+static gint prefetch_window_count;
+static gint prefetches_sent;
+static gint prefetch_hits;
+
+/* NOTE: Rate limit state shared by every request to the API, taken
+ * from the Ratelimit-* headers of the last response. A limit of zero
+ * means Twitch hasn't told us one and only 429s hold us back. */
+static GMutex governor_mutex;
+static GCond governor_cond;
+static gint ratelimit_limit;
+static gint ratelimit_remaining;
+static gint64 ratelimit_reset;
+static gint64 backoff_until;
+static gint backoff_level;
+static gint governor_waiting[NUM_REQUEST_PRIORITIES];
+static GQueue governor_queue[NUM_REQUEST_PRIORITIES];
+static guint governor_source;
+
 static GtTwitchStreamAccessToken*
 gt_twitch_stream_access_token_new()
 {
@@ -209,6 +364,44 @@ gt_twitch_stream_access_token_free(GtTwitchStreamAccessToken* token)
     g_free(token);
 }
 
+static GtTwitchStreamAccessToken*
+stream_access_token_copy(const GtTwitchStreamAccessToken* token)
+{
+    GtTwitchStreamAccessToken* ret = gt_twitch_stream_access_token_new();
+
+    ret->token = g_strdup(token->token);
+    ret->sig = g_strdup(token->sig);
+
+    return ret;
+}
+
+static GList*
+stream_data_list_copy(GList* list)
+{
+    GList* ret = NULL;
+
+    for (GList* l = list; l != NULL; l = l->next)
+    {
+        GtTwitchStreamData* data = l->data;
+        GtTwitchStreamData* copy = g_memdup(data, sizeof(GtTwitchStreamData));
+
+        copy->quality = g_strdup(data->quality);
+        copy->url = g_strdup(data->url);
+
+        ret = g_list_prepend(ret, copy);
+    }
+
+    return g_list_reverse(ret);
+}
+
+static void
+playlist_cache_entry_free(PlaylistCacheEntry* entry)
+{
+    gt_twitch_stream_access_token_free(entry->token);
+    gt_twitch_stream_data_list_free(entry->streams);
+    g_slice_free(PlaylistCacheEntry, entry);
+}
+
 GtChatEmote*
 gt_chat_emote_new()
 {
@@ -250,9 +443,57 @@ gt_twitch_new(void)
                         NULL);
 }
 
+static void parse_json_response_cb(gpointer data, gpointer udata);
+static void request_thread_cb(gpointer data, gpointer udata);
+static void cache_entry_free(CacheEntry* entry);
+
 static void
 gt_twitch_class_init(GtTwitchClass* klass)
 {
+    cache_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) cache_entry_free);
+    flight_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, NULL);
+    playlist_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) playlist_cache_entry_free);
+    prefetch_pending = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, NULL);
+
+    for (gint i = 0; i < NUM_REQUEST_PRIORITIES; i++)
+        g_queue_init(&governor_queue[i]);
+
+    parse_pool = g_thread_pool_new(parse_json_response_cb, NULL,
+        MAX_PARSE_THREADS, FALSE, NULL);
+    request_pool = g_thread_pool_new(request_thread_cb, NULL,
+        MAX_REQUEST_THREADS, FALSE, NULL);
+}
+
+/* NOTE: Entries point at these so they're updated in place, under the
+ * cache lock since that's where the times are read */
+static void
+load_cache_policies(GSettings* settings)
+{
+    g_autoptr(GVariant) overrides = g_settings_get_value(settings, "response-cache-ttls");
+
+    g_mutex_lock(&cache_mutex);
+
+    for (guint i = 0; i < G_N_ELEMENTS(cache_policies); i++)
+    {
+        gint ttl, max_stale;
+
+        cache_policies[i] = default_cache_policies[i];
+
+        if (g_variant_lookup(overrides, cache_policies[i].path, "(ii)", &ttl, &max_stale))
+        {
+            DEBUG("Using ttl '%d' and max stale '%d' seconds for '%s'",
+                ttl, max_stale, cache_policies[i].path);
+
+            cache_policies[i].ttl = MAX(ttl, 0)*G_TIME_SPAN_SECOND;
+            cache_policies[i].max_stale = MAX(max_stale, 0)*G_TIME_SPAN_SECOND;
+        }
+    }
+
+    g_mutex_unlock(&cache_mutex);
 }
 
 static void
@@ -260,9 +501,15 @@ gt_twitch_init(GtTwitch* self)
 {
     GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
 
-    priv->soup = soup_session_new();
+    priv->soup = soup_session_new_with_options(
+        SOUP_SESSION_MAX_CONNS, MAX_CONNS,
+        SOUP_SESSION_MAX_CONNS_PER_HOST, MAX_CONNS_PER_HOST,
+        NULL);
     priv->emote_table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_object_unref);
     priv->badge_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) gt_chat_badge_free);
+    priv->search_pages = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    priv->search_prefetch_page = -1;
+    g_mutex_init(&priv->search_mutex);
 
     g_autofree gchar* emotes_filepath = g_build_filename(g_get_user_cache_dir(),
         "gnome-twitch", "emotes", NULL);
@@ -278,6 +525,11 @@ gt_twitch_init(GtTwitch* self)
 
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), emote_downloader);
     g_signal_connect_swapped(main_app, "shutdown", G_CALLBACK(g_object_unref), badge_downloader);
+
+    load_cache_policies(main_app->settings);
+
+    g_signal_connect(main_app->settings, "changed::response-cache-ttls",
+        G_CALLBACK(load_cache_policies), NULL);
 }
 
 static gboolean
@@ -307,22 +559,13 @@ send_message(GtTwitch* self, SoupMessage* msg)
     return ret;
 }
 
-//TODO: Refactor GtTwitch to use these new functions
 static void
-new_send_message(GtTwitch* self, SoupMessage* msg, GError** error)
+check_response(SoupMessage* msg, GError** error)
 {
-    g_assert(GT_IS_TWITCH(self));
     g_assert(SOUP_IS_MESSAGE(msg));
 
-    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
     char* uri = soup_uri_to_string(soup_message_get_uri(msg), FALSE);
 
-    DEBUGF("Sending message to uri '%s'", uri);
-
-    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
-
-    soup_session_send_message(priv->soup, msg);
-
     if (SOUP_STATUS_IS_SUCCESSFUL(msg->status_code))
     {
         TRACEF("Received response from url '%s' with code '%d' and body '%s'",
@@ -335,8 +578,12 @@ new_send_message(GtTwitch* self, SoupMessage* msg, GError** error)
         WARNINGF("Received unsuccessful response from url '%s' with code '%d' and body '%s'",
                  uri, msg->status_code, msg->response_body->data);
 
-        code = msg->status_code == GT_TWITCH_ERROR_SOUP_NOT_FOUND ?
-            GT_TWITCH_ERROR_SOUP_NOT_FOUND : GT_TWITCH_ERROR_SOUP_GENERIC;
+        if (msg->status_code == GT_TWITCH_ERROR_SOUP_NOT_FOUND)
+            code = GT_TWITCH_ERROR_SOUP_NOT_FOUND;
+        else if (msg->status_code == GT_TWITCH_ERROR_SOUP_TOO_MANY_REQUESTS)
+            code = GT_TWITCH_ERROR_SOUP_TOO_MANY_REQUESTS;
+        else
+            code = GT_TWITCH_ERROR_SOUP_GENERIC;
 
         g_set_error(error, GT_TWITCH_ERROR, code,
             "Received unsuccessful response from url '%s' with code '%d' and body '%s'",
@@ -346,223 +593,1496 @@ new_send_message(GtTwitch* self, SoupMessage* msg, GError** error)
     g_free(uri);
 }
 
-static JsonReader*
-new_send_message_json_with_version(GtTwitch* self, SoupMessage* msg, const gchar* version, GError** error)
+static GBytes*
+response_body_bytes(SoupMessage* msg)
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert(SOUP_IS_MESSAGE(msg));
+    g_autoptr(SoupBuffer) buf = soup_message_body_flatten(msg->response_body);
 
-    JsonReader* ret = NULL;
-    g_autofree gchar* accept_header = g_strdup_printf("application/vnd.twitchtv.v%s+json", version);
+    return soup_buffer_get_as_bytes(buf);
+}
 
-    soup_message_headers_append(msg->request_headers, "Accept", accept_header);
+static JsonNode*
+parse_json_root(GBytes* body, GError** error)
+{
+    g_assert_nonnull(body);
+
+    JsonNode* ret = NULL;
+    JsonParser* parser = json_parser_new();
+    JsonNode* node = NULL;
+    GError* e = NULL;
+    gsize len = 0;
+    const gchar* data = g_bytes_get_data(body, &len);
 
-    new_send_message(self, msg, error);
+    json_parser_load_from_data(parser, data, len, &e);
 
-    if (!*error)
+    if (e)
     {
-        JsonParser* parser = json_parser_new();
-        JsonNode* node = NULL;
-        GError* e = NULL;
+        g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_JSON,
+            "Error parsing JSON response because: %s", e->message);
 
-        json_parser_load_from_data(parser, msg->response_body->data, -1, &e);
+        WARNINGF("Error parsing JSON response because: %s", e->message);
 
-        if (e)
-        {
-            g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_JSON,
-                "Error parsing JSON response because: %s", e->message);
+        g_error_free(e);
 
-            WARNINGF("Error parsing JSON response because: %s", e->message);
+        goto finish;
+    }
 
-            g_error_free(e);
+    node = json_parser_get_root(parser);
+    ret = json_node_ref(node); //NOTE: Keep the root alive after the parser is gone
 
-            goto finish;
-        }
+finish:
+    g_object_unref(G_OBJECT(parser));
 
-        node = json_parser_get_root(parser);
-        ret = json_reader_new(json_node_ref(node)); //NOTE: Parser doesn't seem to have its own reference to node
+    return ret;
+}
 
-        g_object_unref(G_OBJECT(parser));
-    }
+static JsonReader*
+json_reader_new_take_root(JsonNode* root)
+{
+    JsonReader* ret = json_reader_new(root);
+
+    json_node_unref(root); //NOTE: The reader keeps its own copy
 
-finish:
     return ret;
 }
 
 static JsonReader*
-new_send_message_json(GtTwitch* self, SoupMessage* msg, GError** error)
+parse_json_response(GBytes* body, GError** error)
 {
-    return new_send_message_json_with_version(self, msg, TWITCH_API_VERSION_5, error);
+    JsonNode* root = parse_json_root(body, error);
+
+    return root ? json_reader_new_take_root(root) : NULL;
 }
 
-static GDateTime*
-parse_time(const gchar* time)
+static void
+append_accept_header(SoupMessage* msg, const gchar* version)
 {
-    GDateTime* ret = NULL;
+    g_autofree gchar* accept_header = g_strdup_printf("application/vnd.twitchtv.v%s+json", version);
 
-    gint year, month, day, hour, min, sec;
+    soup_message_headers_append(msg->request_headers, "Accept", accept_header);
+}
 
-    sscanf(time, "%d-%d-%dT%d:%d:%dZ", &year, &month, &day, &hour, &min, &sec);
+static void
+cache_entry_free(CacheEntry* entry)
+{
+    g_bytes_unref(entry->body);
 
-    ret = g_date_time_new_utc(year, month, day, hour, min, sec);
+    g_slice_free(CacheEntry, entry);
+}
 
-    return ret;
+static const CachePolicy*
+cache_policy_for_message(SoupMessage* msg)
+{
+    if (msg->method != SOUP_METHOD_GET)
+        return NULL;
+
+    //NOTE: For polling, where a stale answer is worse than a slow one
+    if (g_object_get_data(G_OBJECT(msg), "uncached"))
+        return NULL;
+
+    SoupURI* uri = soup_message_get_uri(msg);
+    const gchar* path = soup_uri_get_path(uri);
+    const gchar* query = soup_uri_get_query(uri);
+
+    /* NOTE: Anything asked for on the user's behalf, like their followed
+     * streams, has to agree with their other follow requests which aren't cached */
+    if (query && strstr(query, "oauth_token="))
+        return NULL;
+
+    for (guint i = 0; i < G_N_ELEMENTS(cache_policies); i++)
+    {
+        if (g_pattern_match_simple(cache_policies[i].path, path))
+            return &cache_policies[i];
+    }
+
+    return NULL;
 }
 
-static GList*
-parse_playlist(const gchar* playlist)
+static gint
+compare_query_params(gconstpointer a, gconstpointer b)
 {
-    GList* ret = NULL;
-    g_auto(GStrv) lines = g_strsplit(playlist, "\n", 0);
+    return g_strcmp0(*(const gchar**) a, *(const gchar**) b);
+}
 
-    for (gchar** l = lines; *l != NULL; l++)
+/* NOTE: The same request can be built with its query parameters in any
+ * order and the response also depends on the API version we ask for */
+static gchar*
+cache_key_for_message(SoupMessage* msg, const gchar* version)
+{
+    SoupURI* uri = soup_message_get_uri(msg);
+    const gchar* query = soup_uri_get_query(uri);
+    GString* key = g_string_new(NULL);
+
+    g_string_append_printf(key, "v%s %s://%s:%u%s",
+        version, soup_uri_get_scheme(uri), soup_uri_get_host(uri),
+        soup_uri_get_port(uri), soup_uri_get_path(uri));
+
+    if (!utils_str_empty(query))
     {
-        if (strncmp(*l, STREAM_INFO, strlen(STREAM_INFO)) == 0)
-        {
-            GtTwitchStreamData* stream = g_malloc0(sizeof(GtTwitchStreamData));
+        g_auto(GStrv) params = g_strsplit(query, "&", -1);
 
-            g_auto(GStrv) values = g_strsplit(*l, ",", 0);
+        qsort(params, g_strv_length(params), sizeof(gchar*), compare_query_params);
 
-            for (gchar** m = values; *m != NULL; m++)
-            {
-                g_auto(GStrv) split = g_strsplit(*m, "=", 0);
+        for (gchar** p = params; *p != NULL; p++)
+        {
+            if (utils_str_empty(*p)) continue;
 
-                if (strcmp(*split, "BANDWIDTH") == 0)
-                {
-                    stream->bandwidth = atol(*(split+1));
-                }
-                else if (strcmp(*split, "RESOLUTION") == 0)
-                {
-                    gchar** res = g_strsplit(*(split+1), "x", 0);
+            g_string_append_c(key, p == params ? '?' : '&');
+            g_string_append(key, *p);
+        }
+    }
 
-                    stream->width = atoi(*res);
-                    stream->height = atoi(*(res+1));
+    return g_string_free(key, FALSE);
+}
 
-                    g_strfreev(res);
-                }
-                else if (strcmp(*split, "VIDEO") == 0)
-                {
-                    //TODO: Replace these with an error
-                    g_assert(g_str_has_prefix(*(split+1), "\""));
-                    g_assert(g_str_has_suffix(*(split+1), "\""));
+/* NOTE: Returns the cached body, if any is still servable, and sets
+ * revalidate if it should be refetched. Only one caller at a time is
+ * told to refetch. */
+static GBytes*
+cache_lookup(const gchar* key, gboolean* revalidate)
+{
+    GBytes* ret = NULL;
 
-                    //NOTE: quality isn't const but still shouldn't be freed,
-                    //it will be freed when split is freed.
-                    gchar* quality = *(split+1)+1;
-                    quality[strlen(quality) - 1] = '\0';
+    *revalidate = FALSE;
 
-                    if (STRING_EQUALS(quality, "chunked"))
-                        stream->quality = g_strdup("source");
-                    else if (STRING_EQUALS(quality, "audio_only")) //NOTE: Remove audio only streams
-                    {
-                        gt_twitch_stream_data_free(stream);
+    g_mutex_lock(&cache_mutex);
 
-                        stream = NULL;
+    CacheEntry* entry = g_hash_table_lookup(cache_table, key);
 
-                        goto next;
-                    }
-                    else
-                        stream->quality = g_strdup(quality);
-                }
-            }
+    if (entry)
+    {
+        GTimeSpan age = g_get_monotonic_time() - entry->timestamp;
 
-            l++;
+        if (age <= entry->policy->ttl)
+        {
+            TRACE("Serving fresh response for '%s'", key);
 
-            stream->url = g_strdup(*l);
+            ret = g_bytes_ref(entry->body);
+        }
+        else if (age <= entry->policy->ttl + entry->policy->max_stale)
+        {
+            TRACE("Serving stale response for '%s'", key);
 
-        next:
-            if (stream) ret = g_list_append(ret, stream);
+            ret = g_bytes_ref(entry->body);
+
+            if (!entry->revalidating)
+                *revalidate = entry->revalidating = TRUE;
         }
     }
 
+    g_mutex_unlock(&cache_mutex);
+
     return ret;
 }
 
-static GtChannelData*
-parse_channel(JsonReader* reader, GError** error)
+static void
+cache_store(const gchar* key, const CachePolicy* policy, GBytes* body)
 {
-    GtChannelData* data = gt_channel_data_new();
+    gint64 now = g_get_monotonic_time();
+    CacheEntry* entry = g_slice_new0(CacheEntry);
 
-    //NOTE: Need this hack until Twitch gets their shit together
-    //and standardizes on either integers or strings as IDs
-    READ_JSON_MEMBER("_id");
-    JsonNode* node = json_reader_get_value(reader);
-    if (STRING_EQUALS(json_node_type_name(node), "Integer"))
-        data->id = g_strdup_printf("%" G_GINT64_FORMAT, json_reader_get_int_value(reader));
-    else if (STRING_EQUALS(json_node_type_name(node), "String"))
-        data->id = g_strdup(json_reader_get_string_value(reader));
-    else
-        g_assert_not_reached();
-    END_JSON_MEMBER();
+    entry->body = g_bytes_ref(body);
+    entry->timestamp = now;
+    entry->policy = policy;
 
-    READ_JSON_VALUE("name", data->name);
-    READ_JSON_VALUE_NULL("display_name", data->display_name, NULL);
-    READ_JSON_VALUE_NULL("status", data->status, _("Untitled broadcast"));
-    READ_JSON_VALUE_NULL("video_banner", data->video_banner_url, NULL);
-    READ_JSON_VALUE_NULL("logo", data->logo_url, NULL);
-    READ_JSON_VALUE("url", data->profile_url);
+    g_mutex_lock(&cache_mutex);
 
-    data->online = FALSE;
+    /* NOTE: Drop anything that can no longer be served before growing */
+    if (g_hash_table_size(cache_table) >= MAX_CACHE_ENTRIES)
+    {
+        GHashTableIter iter;
+        CacheEntry* e;
 
-    return data;
+        g_hash_table_iter_init(&iter, cache_table);
 
-error:
-    gt_channel_data_free(data);
+        while (g_hash_table_iter_next(&iter, NULL, (gpointer*) &e))
+        {
+            if (now - e->timestamp > e->policy->ttl + e->policy->max_stale)
+                g_hash_table_iter_remove(&iter);
+        }
 
-    return NULL;
-}
+        /* NOTE: Still full of servable responses, make room by dropping the oldest */
+        while (g_hash_table_size(cache_table) >= MAX_CACHE_ENTRIES)
+        {
+            const gchar* oldest_key = NULL;
+            gint64 oldest = G_MAXINT64;
+            const gchar* k;
 
-static GtChannelData*
-parse_stream(JsonReader* reader, GError** error)
-{
-    GtChannelData* data = NULL;
+            g_hash_table_iter_init(&iter, cache_table);
 
-    READ_JSON_MEMBER("channel");
-    data = parse_channel(reader, error);
-    END_JSON_MEMBER();
+            while (g_hash_table_iter_next(&iter, (gpointer*) &k, (gpointer*) &e))
+            {
+                if (e->timestamp < oldest)
+                {
+                    oldest = e->timestamp;
+                    oldest_key = k;
+                }
+            }
 
-    if (*error) goto error;
+            g_hash_table_remove(cache_table, oldest_key);
+        }
+    }
 
-    READ_JSON_VALUE_NULL("game", data->game, NULL);
-    READ_JSON_VALUE("viewers", data->viewers);
-    READ_JSON_VALUE("created_at", data->stream_started_time);
-    READ_JSON_MEMBER("preview");
-    READ_JSON_VALUE("large", data->preview_url);
-    END_JSON_MEMBER();
+    g_hash_table_insert(cache_table, g_strdup(key), entry);
 
-    data->online = TRUE;
+    g_mutex_unlock(&cache_mutex);
+}
 
-    return data;
+static void
+cache_revalidate_failed(const gchar* key)
+{
+    g_mutex_lock(&cache_mutex);
 
-error:
-    gt_channel_data_free(data);
+    CacheEntry* entry = g_hash_table_lookup(cache_table, key);
 
-    return NULL;
+    if (entry)
+        entry->revalidating = FALSE;
+
+    g_mutex_unlock(&cache_mutex);
 }
 
-static GtGameData*
-parse_game(JsonReader* reader, GError** error)
+static void
+request_data_free(RequestData* req)
+{
+    g_clear_object(&req->task);
+    g_object_unref(req->msg);
+    g_clear_pointer(&req->body, g_bytes_unref);
+    g_clear_pointer(&req->root, json_node_unref);
+    g_free(req->cache_key);
+
+    g_slice_free(RequestData, req);
+}
+
+static void queue_request(RequestData* req);
+static gboolean queue_message_cb(gpointer udata);
+
+static void
+set_message_priority(SoupMessage* msg, RequestPriority priority)
+{
+    g_object_set_data(G_OBJECT(msg), "priority", GINT_TO_POINTER(priority));
+}
+
+//NOTE: Anything not explicitly marked is something the user asked for
+static RequestPriority
+get_message_priority(SoupMessage* msg)
+{
+    return GPOINTER_TO_INT(g_object_get_data(G_OBJECT(msg), "priority"));
+}
+
+static gboolean
+message_is_governed(SoupMessage* msg)
+{
+    return STRING_EQUALS(soup_uri_get_host(soup_message_get_uri(msg)), GOVERNED_HOST);
+}
+
+/* NOTE: Returns zero if a request with this priority may be sent right
+ * away, otherwise the monotonic time to check again at or -1 if it has
+ * to wait for a higher priority request to go first. Call locked. */
+static gint64
+governor_ready_time(RequestPriority priority)
+{
+    gint64 now = g_get_monotonic_time();
+    gint reserve;
+
+    if (now < backoff_until)
+        return backoff_until;
+
+    for (gint i = 0; i < priority; i++)
+        if (governor_waiting[i] > 0) return -1;
+
+    if (ratelimit_limit <= 0)
+        return 0;
+
+    //NOTE: The bucket has refilled, assume a full one until told otherwise
+    if (now >= ratelimit_reset)
+    {
+        ratelimit_remaining = ratelimit_limit;
+        ratelimit_reset = now + G_USEC_PER_SEC;
+    }
+
+    reserve = ratelimit_limit * priority / 8;
+
+    return ratelimit_remaining > reserve ? 0 : ratelimit_reset;
+}
+
+static gboolean governor_dispatch_cb(gpointer udata);
+
+static void
+governor_schedule()
+{
+    g_main_context_invoke(NULL, governor_dispatch_cb, NULL);
+}
+
+/* NOTE: Blocks the calling thread until the request may be sent */
+static void
+governor_acquire(RequestPriority priority)
+{
+    gint64 ready;
+
+    g_mutex_lock(&governor_mutex);
+
+    governor_waiting[priority]++;
+
+    while ((ready = governor_ready_time(priority)) != 0)
+    {
+        if (ready < 0)
+            g_cond_wait(&governor_cond, &governor_mutex);
+        else
+            g_cond_wait_until(&governor_cond, &governor_mutex, ready);
+    }
+
+    governor_waiting[priority]--;
+
+    if (ratelimit_limit > 0)
+        ratelimit_remaining--;
+
+    //NOTE: Lower priorities may have been waiting on us
+    g_cond_broadcast(&governor_cond);
+
+    g_mutex_unlock(&governor_mutex);
+
+    governor_schedule();
+}
+
+static void
+governor_enqueue(RequestData* req)
+{
+    RequestPriority priority = get_message_priority(req->msg);
+
+    g_mutex_lock(&governor_mutex);
+
+    g_queue_push_tail(&governor_queue[priority], req);
+    governor_waiting[priority]++;
+
+    g_mutex_unlock(&governor_mutex);
+
+    governor_schedule();
+}
+
+static gboolean
+governor_dispatch_cb(gpointer udata)
+{
+    GList* ready_reqs = NULL;
+    gint64 ready = 0;
+
+    //NOTE: Only our own timeout passes TRUE, it's done once it fires
+    if (GPOINTER_TO_INT(udata))
+        governor_source = 0;
+
+    g_mutex_lock(&governor_mutex);
+
+    for (gint i = 0; i < NUM_REQUEST_PRIORITIES && ready == 0; i++)
+    {
+        while (!g_queue_is_empty(&governor_queue[i]))
+        {
+            if ((ready = governor_ready_time(i)) != 0)
+                break;
+
+            ready_reqs = g_list_prepend(ready_reqs, g_queue_pop_head(&governor_queue[i]));
+            governor_waiting[i]--;
+
+            if (ratelimit_limit > 0)
+                ratelimit_remaining--;
+        }
+    }
+
+    if (ready > 0 && governor_source == 0)
+    {
+        guint interval = MAX((ready - g_get_monotonic_time()) / 1000, 1);
+
+        governor_source = g_timeout_add(interval, governor_dispatch_cb, GINT_TO_POINTER(TRUE));
+    }
+
+    g_cond_broadcast(&governor_cond);
+
+    g_mutex_unlock(&governor_mutex);
+
+    ready_reqs = g_list_reverse(ready_reqs);
+
+    for (GList* l = ready_reqs; l != NULL; l = l->next)
+        queue_message_cb(l->data);
+
+    g_list_free(ready_reqs);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* NOTE: Updates the shared state from a response and returns TRUE if
+ * it should be retried because we were rate limited. Twitch sends the
+ * reset as a unix timestamp, we keep everything on the monotonic clock. */
+static gboolean
+governor_response(SoupMessage* msg, gint attempt)
+{
+    const gchar* limit = soup_message_headers_get_one(msg->response_headers, "Ratelimit-Limit");
+    const gchar* remaining = soup_message_headers_get_one(msg->response_headers, "Ratelimit-Remaining");
+    const gchar* reset = soup_message_headers_get_one(msg->response_headers, "Ratelimit-Reset");
+    gboolean limited = msg->status_code == GT_TWITCH_ERROR_SOUP_TOO_MANY_REQUESTS;
+    gint64 now = g_get_monotonic_time();
+    gint64 reset_time = 0;
+
+    if (reset)
+    {
+        reset_time = now + (g_ascii_strtoll(reset, NULL, 10) -
+            g_get_real_time() / G_USEC_PER_SEC) * G_USEC_PER_SEC;
+    }
+
+    g_mutex_lock(&governor_mutex);
+
+    if (limit && remaining && reset)
+    {
+        ratelimit_limit = atoi(limit);
+        ratelimit_remaining = atoi(remaining);
+        ratelimit_reset = reset_time;
+    }
+
+    if (limited)
+    {
+        gint64 delay = MIN(RETRY_BACKOFF << MIN(backoff_level, 6), MAX_RETRY_BACKOFF);
+
+        backoff_level++;
+
+        if (reset_time > now)
+            delay = MIN(reset_time - now, MAX_RETRY_BACKOFF);
+
+        backoff_until = MAX(backoff_until, now + delay);
+
+        WARNINGF("Rate limited by Twitch, backing off for '%" G_GINT64_FORMAT "' ms", delay / 1000);
+    }
+    else if (SOUP_STATUS_IS_SUCCESSFUL(msg->status_code))
+        backoff_level = 0;
+
+    g_cond_broadcast(&governor_cond);
+
+    g_mutex_unlock(&governor_mutex);
+
+    governor_schedule();
+
+    return limited && attempt < MAX_RETRIES;
+}
+
+
+/* NOTE: Refetches a stale response in the background, nobody is
+ * waiting for it so it just ends up in the cache */
+static void
+cache_revalidate(GtTwitch* self, SoupMessage* msg, const gchar* key)
+{
+    RequestData* req = g_slice_new0(RequestData);
+
+    DEBUG("Revalidating cached response for '%s'", key);
+
+    req->msg = soup_message_new_from_uri(msg->method, soup_message_get_uri(msg));
+    req->cache_key = g_strdup(key);
+
+    soup_message_headers_append(req->msg->request_headers, "Client-ID", CLIENT_ID);
+    soup_message_headers_append(req->msg->request_headers, "Accept",
+        soup_message_headers_get_one(msg->request_headers, "Accept"));
+
+    g_object_set_data_full(G_OBJECT(req->msg), "twitch", g_object_ref(self), g_object_unref);
+
+    set_message_priority(req->msg, REQUEST_PRIORITY_LOW);
+
+    queue_request(req);
+}
+
+static void
+flight_unref(Flight* flight)
+{
+    if (!g_atomic_int_dec_and_test(&flight->ref_count))
+        return;
+
+    g_assert_null(flight->followers);
+
+    g_mutex_clear(&flight->mutex);
+    g_cond_clear(&flight->cond);
+    g_clear_pointer(&flight->body, g_bytes_unref);
+    g_clear_pointer(&flight->root, json_node_unref);
+    g_clear_error(&flight->error);
+
+    g_slice_free(Flight, flight);
+}
+
+/* NOTE: Returns the flight for this key with a new ref and sets leader
+ * if the caller is the one that has to send the request. Asynchronous
+ * followers pass their request data and get dispatched on finish. */
+static Flight*
+flight_join(const gchar* key, RequestData* follower, gboolean* leader)
+{
+    Flight* flight = NULL;
+
+    g_mutex_lock(&flight_mutex);
+
+    flight = g_hash_table_lookup(flight_table, key);
+
+    if (flight)
+    {
+        g_mutex_lock(&flight->mutex);
+
+        if (follower)
+            flight->followers = g_list_prepend(flight->followers, follower);
+
+        g_mutex_unlock(&flight->mutex);
+
+        g_atomic_int_inc(&flight->ref_count);
+
+        *leader = FALSE;
+
+        gint coalesced = g_atomic_int_add(&flights_coalesced, 1) + 1;
+
+        DEBUG("Coalesced request for '%s', saved %d out of %d requests",
+            key, coalesced, coalesced + g_atomic_int_get(&flights_sent));
+    }
+    else
+    {
+        flight = g_slice_new0(Flight);
+        flight->ref_count = 2; //NOTE: One for the table and one for the leader
+        g_mutex_init(&flight->mutex);
+        g_cond_init(&flight->cond);
+
+        g_hash_table_insert(flight_table, g_strdup(key), flight);
+
+        *leader = TRUE;
+
+        g_atomic_int_inc(&flights_sent);
+    }
+
+    g_mutex_unlock(&flight_mutex);
+
+    return flight;
+}
+
+/* NOTE: The body is always shared, the root only if the leader had to
+ * build one anyway. Followers that want a tree parse the body if not. */
+static void
+flight_finish(Flight* flight, const gchar* key, GBytes* body, JsonNode* root, const GError* error)
+{
+    GList* followers = NULL;
+    gboolean removed = FALSE;
+
+    g_mutex_lock(&flight_mutex);
+
+    /* NOTE: From here on new callers start a flight of their own */
+    if (g_hash_table_lookup(flight_table, key) == flight)
+        removed = g_hash_table_remove(flight_table, key);
+
+    g_mutex_unlock(&flight_mutex);
+
+    g_mutex_lock(&flight->mutex);
+
+    flight->done = TRUE;
+    flight->body = body ? g_bytes_ref(body) : NULL;
+    flight->root = root ? json_node_ref(root) : NULL;
+    flight->error = error ? g_error_copy(error) : NULL;
+    followers = g_steal_pointer(&flight->followers);
+
+    g_cond_broadcast(&flight->cond);
+
+    g_mutex_unlock(&flight->mutex);
+
+    for (GList* l = followers; l != NULL; l = l->next)
+    {
+        RequestData* req = l->data;
+
+        if (error)
+        {
+            g_task_return_error(req->task, g_error_copy(error));
+            request_data_free(req);
+        }
+        else
+        {
+            req->body = g_bytes_ref(body);
+            req->root = root ? json_node_ref(root) : NULL;
+            g_thread_pool_push(parse_pool, req, NULL);
+        }
+    }
+
+    g_list_free(followers);
+
+    if (removed)
+        flight_unref(flight);
+
+    flight_unref(flight);
+}
+
+static GBytes*
+flight_wait(Flight* flight, JsonNode** root, GError** error)
+{
+    GBytes* ret = NULL;
+
+    g_mutex_lock(&flight->mutex);
+
+    while (!flight->done)
+        g_cond_wait(&flight->cond, &flight->mutex);
+
+    if (flight->error)
+        g_propagate_error(error, g_error_copy(flight->error));
+    else
+    {
+        ret = g_bytes_ref(flight->body);
+
+        if (root && flight->root)
+            *root = json_node_ref(flight->root);
+    }
+
+    g_mutex_unlock(&flight->mutex);
+
+    if (ret && root && !*root)
+    {
+        *root = parse_json_root(ret, error);
+
+        if (!*root)
+            g_clear_pointer(&ret, g_bytes_unref);
+    }
+
+    return ret;
+}
+
+//TODO: Refactor GtTwitch to use these new functions
+static void
+new_send_message(GtTwitch* self, SoupMessage* msg, GError** error)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert(SOUP_IS_MESSAGE(msg));
+
+    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
+    char* uri = soup_uri_to_string(soup_message_get_uri(msg), FALSE);
+
+    DEBUGF("Sending message to uri '%s'", uri);
+
+    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
+
+    for (gint attempt = 0; ; attempt++)
+    {
+        if (message_is_governed(msg))
+            governor_acquire(get_message_priority(msg));
+
+        soup_session_send_message(priv->soup, msg);
+
+        if (!message_is_governed(msg) || !governor_response(msg, attempt))
+            break;
+
+        DEBUGF("Retrying rate limited message to uri '%s'", uri);
+    }
+
+    check_response(msg, error);
+
+    g_free(uri);
+}
+
+/* NOTE: Returns the response body, going through the cache and any
+ * identical request in flight first. A tree is only built if root is
+ * given, a NULL return always comes with an error set. */
+static GBytes*
+new_send_message_body(GtTwitch* self, SoupMessage* msg, const gchar* version,
+    JsonNode** root, GError** error)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert(SOUP_IS_MESSAGE(msg));
+
+    const CachePolicy* policy = cache_policy_for_message(msg);
+    g_autofree gchar* key = cache_key_for_message(msg, version);
+    GBytes* body = NULL;
+    JsonNode* tree = NULL;
+    Flight* flight = NULL;
+    GError* err = NULL;
+
+    append_accept_header(msg, version);
+
+    if (policy)
+    {
+        gboolean revalidate = FALSE;
+
+        body = cache_lookup(key, &revalidate);
+
+        if (revalidate)
+            cache_revalidate(self, msg, key);
+
+        if (body)
+            goto finish;
+    }
+
+    if (msg->method == SOUP_METHOD_GET)
+    {
+        gboolean leader = FALSE;
+
+        flight = flight_join(key, NULL, &leader);
+
+        if (!leader)
+        {
+            body = flight_wait(flight, root, error);
+
+            flight_unref(flight);
+
+            return body;
+        }
+    }
+
+    new_send_message(self, msg, &err);
+
+    if (!err)
+    {
+        body = response_body_bytes(msg);
+
+        if (policy)
+            cache_store(key, policy, body);
+
+        if (root)
+            tree = parse_json_root(body, NULL);
+    }
+
+    if (flight)
+        flight_finish(flight, key, body, tree, err);
+
+    if (err)
+    {
+        g_propagate_error(error, err);
+
+        return NULL;
+    }
+
+finish:
+    if (root)
+    {
+        /* NOTE: Parse again for the error if the tree couldn't be built */
+        *root = tree ? tree : parse_json_root(body, error);
+
+        if (!*root)
+            g_clear_pointer(&body, g_bytes_unref);
+    }
+
+    return body;
+}
+
+static JsonReader*
+new_send_message_json_with_version(GtTwitch* self, SoupMessage* msg, const gchar* version, GError** error)
+{
+    g_autoptr(GBytes) body = NULL;
+    JsonNode* root = NULL;
+
+    body = new_send_message_body(self, msg, version, &root, error);
+
+    return body ? json_reader_new_take_root(root) : NULL;
+}
+
+static gpointer
+decode_json_response(GtTwitch* self, GBytes* body,
+    DecodeJsonFunc decode, GenericTaskData* params, GError** error)
+{
+    GtJsonScanner scanner;
+    gsize len = 0;
+    const gchar* data = g_bytes_get_data(body, &len);
+    gpointer ret = NULL;
+    GError* err = NULL;
+
+    gt_json_scanner_init(&scanner, data, len);
+
+    ret = decode(self, &scanner, params, &err);
+
+    gt_json_scanner_clear(&scanner);
+
+    //NOTE: Scanner errors come in the GIO domain, keep ours consistent
+    if (err)
+    {
+        g_set_error_literal(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_JSON, err->message);
+        g_error_free(err);
+    }
+
+    return ret;
+}
+
+static JsonReader*
+new_send_message_json(GtTwitch* self, SoupMessage* msg, GError** error)
+{
+    return new_send_message_json_with_version(self, msg, TWITCH_API_VERSION_5, error);
+}
+
+static void
+parse_json_response_cb(gpointer data, gpointer udata)
+{
+    RequestData* req = data;
+    GtTwitch* self = GT_TWITCH(g_task_get_source_object(req->task));
+    GenericTaskData* params = g_task_get_task_data(req->task);
+    g_autoptr(JsonReader) reader = NULL;
+    gpointer ret = NULL;
+    GError* err = NULL;
+
+    /* NOTE: Followers of a flight may be handed the root already parsed */
+    if (!req->decode && !req->root)
+        req->root = parse_json_root(req->body, &err);
+
+    /* NOTE: Others may be waiting on us even if we were cancelled,
+     * they get the body regardless and report their own parse errors */
+    if (req->flight)
+        flight_finish(g_steal_pointer(&req->flight), req->cache_key, req->body, req->root, NULL);
+
+    if (g_task_return_error_if_cancelled(req->task))
+    {
+        g_clear_error(&err);
+
+        goto finish;
+    }
+
+    if (!err && req->decode)
+        ret = decode_json_response(self, req->body, req->decode, params, &err);
+    else if (!err)
+    {
+        reader = json_reader_new_take_root(g_steal_pointer(&req->root));
+        ret = req->parse(self, reader, params, &err);
+    }
+
+    if (err)
+        g_task_return_error(req->task, err);
+    else
+        g_task_return_pointer(req->task, ret, req->result_free);
+
+finish:
+    request_data_free(req);
+}
+
+static void
+send_message_async_cb(SoupSession* session,
+    SoupMessage* msg, gpointer udata)
+{
+    RequestData* req = udata;
+    const CachePolicy* policy = cache_policy_for_message(msg);
+    GError* err = NULL;
+
+    if (req->task && !req->flight && g_task_return_error_if_cancelled(req->task))
+    {
+        request_data_free(req);
+
+        return;
+    }
+
+    if (message_is_governed(msg) && governor_response(msg, req->attempts++))
+    {
+        DEBUG("Retrying rate limited message");
+
+        queue_request(req);
+
+        return;
+    }
+
+    check_response(msg, &err);
+
+    if (!err)
+    {
+        req->body = response_body_bytes(msg);
+
+        if (policy && req->cache_key)
+            cache_store(req->cache_key, policy, req->body);
+    }
+    else if (!req->task)
+        cache_revalidate_failed(req->cache_key);
+
+    if (!req->task)
+    {
+        g_clear_error(&err);
+        request_data_free(req);
+    }
+    else if (err)
+    {
+        if (req->flight)
+            flight_finish(g_steal_pointer(&req->flight), req->cache_key, NULL, NULL, err);
+
+        if (g_task_return_error_if_cancelled(req->task))
+            g_error_free(err);
+        else
+            g_task_return_error(req->task, err);
+
+        request_data_free(req);
+    }
+    else if (!req->parse && !req->decode)
+    {
+        g_task_return_pointer(req->task, NULL, NULL); //NOTE: Nothing to parse, just return null
+        request_data_free(req);
+    }
+    else
+        g_thread_pool_push(parse_pool, req, NULL);
+}
+
+static gboolean
+queue_message_cb(gpointer udata)
+{
+    RequestData* req = udata;
+    GtTwitch* self = req->task ? g_task_get_source_object(req->task) :
+        g_object_get_data(G_OBJECT(req->msg), "twitch");
+    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
+
+    /* NOTE: The session steals a reference to the message */
+    soup_session_queue_message(priv->soup, g_object_ref(req->msg),
+        send_message_async_cb, req);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+queue_request(RequestData* req)
+{
+    /* NOTE: The session is only ever driven from the main context so
+     * this behaves the same no matter which thread we're called from */
+    if (message_is_governed(req->msg))
+        governor_enqueue(req);
+    else
+        g_main_context_invoke(NULL, queue_message_cb, req);
+}
+
+/* NOTE: Sends the message without blocking any thread, then returns
+ * whatever the parse or decode function makes of the response through
+ * the task. A NULL version sends no Accept header and passing neither
+ * function skips parsing altogether. */
+static void
+send_message_async(GtTwitch* self, SoupMessage* msg,
+    const gchar* version, GTask* task, ParseJsonFunc parse,
+    DecodeJsonFunc decode, GDestroyNotify result_free)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert(SOUP_IS_MESSAGE(msg));
+    g_assert(G_IS_TASK(task));
+
+    RequestData* req = g_slice_new0(RequestData);
+    const CachePolicy* policy = version ? cache_policy_for_message(msg) : NULL;
+    g_autofree gchar* uri = soup_uri_to_string(soup_message_get_uri(msg), FALSE);
+
+    soup_message_headers_append(msg->request_headers, "Client-ID", CLIENT_ID);
+
+    if (version)
+        append_accept_header(msg, version);
+
+    req->task = g_object_ref(task);
+    req->msg = g_object_ref(msg);
+    req->parse = parse;
+    req->decode = decode;
+    req->result_free = result_free;
+
+    if (version && (parse || decode) && msg->method == SOUP_METHOD_GET)
+        req->cache_key = cache_key_for_message(msg, version);
+
+    if (policy && req->cache_key)
+    {
+        gboolean revalidate = FALSE;
+
+        req->body = cache_lookup(req->cache_key, &revalidate);
+
+        if (revalidate)
+            cache_revalidate(self, msg, req->cache_key);
+
+        if (req->body)
+        {
+            g_thread_pool_push(parse_pool, req, NULL);
+
+            return;
+        }
+
+        g_clear_pointer(&req->body, g_bytes_unref);
+    }
+
+    if (req->cache_key)
+    {
+        gboolean leader = FALSE;
+        Flight* flight = flight_join(req->cache_key, req, &leader);
+
+        /* NOTE: We'll be dispatched when the leader finishes */
+        if (!leader)
+        {
+            flight_unref(flight);
+
+            return;
+        }
+
+        req->flight = flight;
+    }
+
+    DEBUG("Queueing message to uri '%s'", uri);
+
+    queue_request(req);
+}
+
+static void
+send_message_json_async(GtTwitch* self, SoupMessage* msg,
+    const gchar* version, GTask* task, ParseJsonFunc parse,
+    GDestroyNotify result_free)
+{
+    send_message_async(self, msg, version, task, parse, NULL, result_free);
+}
+
+static void
+send_message_decode_async(GtTwitch* self, SoupMessage* msg,
+    GTask* task, DecodeJsonFunc decode, GDestroyNotify result_free)
+{
+    send_message_async(self, msg, TWITCH_API_VERSION_5, task, NULL, decode, result_free);
+}
+
+static void
+request_thread_cb(gpointer data, gpointer udata)
+{
+    RequestThreadData* req = data;
+
+    req->func(req->task, g_task_get_source_object(req->task),
+        g_task_get_task_data(req->task), g_task_get_cancellable(req->task));
+
+    g_object_unref(req->task);
+
+    g_slice_free(RequestThreadData, req);
+}
+
+/* NOTE: Like g_task_run_in_thread but on our own bounded pool */
+static void
+run_in_request_pool(GTask* task, GTaskThreadFunc func)
+{
+    g_assert(G_IS_TASK(task));
+
+    RequestThreadData* req = g_slice_new0(RequestThreadData);
+
+    req->task = g_object_ref(task);
+    req->func = func;
+
+    g_thread_pool_push(request_pool, req, NULL);
+}
+
+static GDateTime*
+parse_time(const gchar* time)
+{
+    GDateTime* ret = NULL;
+
+    gint year, month, day, hour, min, sec;
+
+    sscanf(time, "%d-%d-%dT%d:%d:%dZ", &year, &month, &day, &hour, &min, &sec);
+
+    ret = g_date_time_new_utc(year, month, day, hour, min, sec);
+
+    return ret;
+}
+
+static GList*
+parse_playlist(const gchar* playlist)
+{
+    GList* ret = NULL;
+    g_auto(GStrv) lines = g_strsplit(playlist, "\n", 0);
+
+    for (gchar** l = lines; *l != NULL; l++)
+    {
+        if (strncmp(*l, STREAM_INFO, strlen(STREAM_INFO)) == 0)
+        {
+            GtTwitchStreamData* stream = g_malloc0(sizeof(GtTwitchStreamData));
+
+            g_auto(GStrv) values = g_strsplit(*l, ",", 0);
+
+            for (gchar** m = values; *m != NULL; m++)
+            {
+                g_auto(GStrv) split = g_strsplit(*m, "=", 0);
+
+                if (strcmp(*split, "BANDWIDTH") == 0)
+                {
+                    stream->bandwidth = atol(*(split+1));
+                }
+                else if (strcmp(*split, "RESOLUTION") == 0)
+                {
+                    gchar** res = g_strsplit(*(split+1), "x", 0);
+
+                    stream->width = atoi(*res);
+                    stream->height = atoi(*(res+1));
+
+                    g_strfreev(res);
+                }
+                else if (strcmp(*split, "VIDEO") == 0)
+                {
+                    //TODO: Replace these with an error
+                    g_assert(g_str_has_prefix(*(split+1), "\""));
+                    g_assert(g_str_has_suffix(*(split+1), "\""));
+
+                    //NOTE: quality isn't const but still shouldn't be freed,
+                    //it will be freed when split is freed.
+                    gchar* quality = *(split+1)+1;
+                    quality[strlen(quality) - 1] = '\0';
+
+                    if (STRING_EQUALS(quality, "chunked"))
+                        stream->quality = g_strdup("source");
+                    else if (STRING_EQUALS(quality, "audio_only")) //NOTE: Remove audio only streams
+                    {
+                        gt_twitch_stream_data_free(stream);
+
+                        stream = NULL;
+
+                        goto next;
+                    }
+                    else
+                        stream->quality = g_strdup(quality);
+                }
+            }
+
+            l++;
+
+            stream->url = g_strdup(*l);
+
+        next:
+            if (stream) ret = g_list_append(ret, stream);
+        }
+    }
+
+    return ret;
+}
+
+static GtChannelData*
+parse_channel(JsonReader* reader, GError** error)
+{
+    GtChannelData* data = gt_channel_data_new();
+
+    //NOTE: Need this hack until Twitch gets their shit together
+    //and standardizes on either integers or strings as IDs
+    READ_JSON_MEMBER("_id");
+    JsonNode* node = json_reader_get_value(reader);
+    if (STRING_EQUALS(json_node_type_name(node), "Integer"))
+        data->id = g_strdup_printf("%" G_GINT64_FORMAT, json_reader_get_int_value(reader));
+    else if (STRING_EQUALS(json_node_type_name(node), "String"))
+        data->id = g_strdup(json_reader_get_string_value(reader));
+    else
+        g_assert_not_reached();
+    END_JSON_MEMBER();
+
+    READ_JSON_VALUE("name", data->name);
+    READ_JSON_VALUE_NULL("display_name", data->display_name, NULL);
+    READ_JSON_VALUE_NULL("status", data->status, _("Untitled broadcast"));
+    READ_JSON_VALUE_NULL("video_banner", data->video_banner_url, NULL);
+    READ_JSON_VALUE_NULL("logo", data->logo_url, NULL);
+    READ_JSON_VALUE("url", data->profile_url);
+
+    data->online = FALSE;
+
+    return data;
+
+error:
+    gt_channel_data_free(data);
+
+    return NULL;
+}
+
+GtChannelData*
+gt_twitch_parse_stream(JsonReader* reader, GError** error)
+{
+    GtChannelData* data = NULL;
+
+    READ_JSON_MEMBER("channel");
+    data = parse_channel(reader, error);
+    END_JSON_MEMBER();
+
+    if (*error) goto error;
+
+    READ_JSON_VALUE_NULL("game", data->game, NULL);
+    READ_JSON_VALUE("viewers", data->viewers);
+    READ_JSON_VALUE("created_at", data->stream_started_time);
+    READ_JSON_MEMBER("preview");
+    READ_JSON_VALUE("large", data->preview_url);
+    END_JSON_MEMBER();
+
+    data->online = TRUE;
+
+    return data;
+
+error:
+    gt_channel_data_free(data);
+
+    return NULL;
+}
+
+GtGameData*
+gt_twitch_parse_game(JsonReader* reader, GError** error)
+{
+    GtGameData* data = gt_game_data_new();
+
+    //NOTE: Same hack as above for channel
+    READ_JSON_MEMBER("_id");
+    JsonNode* node = json_reader_get_value(reader);
+    if (STRING_EQUALS(json_node_type_name(node), "Integer"))
+        data->id = g_strdup_printf("%" G_GINT64_FORMAT, json_reader_get_int_value(reader));
+    else if (STRING_EQUALS(json_node_type_name(node), "String"))
+        data->id = g_strdup(json_reader_get_string_value(reader));
+    else
+        g_assert_not_reached();
+    END_JSON_MEMBER();
+
+    READ_JSON_VALUE("name", data->name);
+    READ_JSON_MEMBER("box");
+    READ_JSON_VALUE("large", data->preview_url);
+    END_JSON_MEMBER();
+    READ_JSON_MEMBER("logo");
+    READ_JSON_VALUE("large", data->logo_url);
+    END_JSON_MEMBER();
+
+    return data;
+
+error:
+    gt_game_data_free(data);
+
+    return NULL;
+}
+
+/* NOTE: Streaming counterparts of the parse functions above. They fill
+ * in the data while scanning the body so no tree is built, members may
+ * come in any order and the ones we don't know about are skipped. */
+
+static gboolean
+decode_unexpected(GtJsonToken token, const gchar* name, GError** error)
+{
+    //NOTE: The scanner has already set an error for invalid tokens
+    if (token != GT_JSON_TOKEN_INVALID)
+    {
+        g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_JSON,
+            "Unexpected value for JSON member with name '%s'", name);
+    }
+
+    return FALSE;
+}
+
+static gboolean
+decode_string(GtJsonScanner* scanner, const gchar* name,
+    gboolean nullable, const gchar* def, gchar** out, GError** error)
+{
+    GtJsonToken token = gt_json_scanner_next(scanner, error);
+
+    if (token == GT_JSON_TOKEN_STRING)
+    {
+        g_free(*out);
+        *out = g_strdup(gt_json_scanner_get_string(scanner));
+    }
+    else if (token == GT_JSON_TOKEN_NULL && nullable)
+    {
+        g_free(*out);
+        *out = g_strdup(def);
+    }
+    else
+        return decode_unexpected(token, name, error);
+
+    return TRUE;
+}
+
+static gboolean
+decode_int(GtJsonScanner* scanner, const gchar* name, gint64* out, GError** error)
+{
+    GtJsonToken token = gt_json_scanner_next(scanner, error);
+
+    if (token != GT_JSON_TOKEN_NUMBER)
+        return decode_unexpected(token, name, error);
+
+    *out = gt_json_scanner_get_int(scanner);
+
+    return TRUE;
+}
+
+//NOTE: Same ID hack as in parse_channel
+static gboolean
+decode_id(GtJsonScanner* scanner, const gchar* name, gchar** out, GError** error)
+{
+    GtJsonToken token = gt_json_scanner_next(scanner, error);
+
+    if (token != GT_JSON_TOKEN_NUMBER && token != GT_JSON_TOKEN_STRING)
+        return decode_unexpected(token, name, error);
+
+    g_free(*out);
+    *out = g_strdup(gt_json_scanner_get_string(scanner));
+
+    return TRUE;
+}
+
+static gboolean
+decode_object(GtJsonScanner* scanner, const gchar* name, GError** error)
+{
+    GtJsonToken token = gt_json_scanner_next(scanner, error);
+
+    if (token != GT_JSON_TOKEN_OBJECT_START)
+        return decode_unexpected(token, name, error);
+
+    return TRUE;
+}
+
+/* NOTE: Moves into the next object of an array, returns FALSE without
+ * setting an error once the array ends */
+static gboolean
+decode_next_object(GtJsonScanner* scanner, const gchar* name, GError** error)
+{
+    GtJsonToken token = gt_json_scanner_next(scanner, error);
+
+    if (token == GT_JSON_TOKEN_OBJECT_START)
+        return TRUE;
+
+    if (token != GT_JSON_TOKEN_ARRAY_END)
+        decode_unexpected(token, name, error);
+
+    return FALSE;
+}
+
+static gboolean
+decode_skip(GtJsonScanner* scanner, GError** error)
+{
+    return gt_json_scanner_skip(scanner, gt_json_scanner_next(scanner, error), error);
+}
+
+//NOTE: Twitch's image objects, we only ever use the large one
+static gboolean
+decode_large_image(GtJsonScanner* scanner, const gchar* name, gchar** out, GError** error)
+{
+    const gchar* member = NULL;
+
+    if (!decode_object(scanner, name, error))
+        return FALSE;
+
+    while (gt_json_scanner_next_member(scanner, &member, error))
+    {
+        gboolean ok = STRING_EQUALS(member, "large") ?
+            decode_string(scanner, "large", FALSE, NULL, out, error) :
+            decode_skip(scanner, error);
+
+        if (!ok) return FALSE;
+    }
+
+    return *error == NULL;
+}
+
+static gboolean
+decode_missing(const gchar* name, GError** error)
+{
+    g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_JSON,
+        "Unable to read JSON member with name '%s'", name);
+
+    return FALSE;
+}
+
+/* NOTE: Expects the object to have been opened already */
+static gboolean
+decode_channel(GtJsonScanner* scanner, GtChannelData* data, GError** error)
+{
+    const gchar* name = NULL;
+
+    while (gt_json_scanner_next_member(scanner, &name, error))
+    {
+        gboolean ok;
+
+        if (STRING_EQUALS(name, "_id"))
+            ok = decode_id(scanner, "_id", &data->id, error);
+        else if (STRING_EQUALS(name, "name"))
+            ok = decode_string(scanner, "name", FALSE, NULL, &data->name, error);
+        else if (STRING_EQUALS(name, "display_name"))
+            ok = decode_string(scanner, "display_name", TRUE, NULL, &data->display_name, error);
+        else if (STRING_EQUALS(name, "status"))
+            ok = decode_string(scanner, "status", TRUE, _("Untitled broadcast"), &data->status, error);
+        else if (STRING_EQUALS(name, "video_banner"))
+            ok = decode_string(scanner, "video_banner", TRUE, NULL, &data->video_banner_url, error);
+        else if (STRING_EQUALS(name, "logo"))
+            ok = decode_string(scanner, "logo", TRUE, NULL, &data->logo_url, error);
+        else if (STRING_EQUALS(name, "url"))
+            ok = decode_string(scanner, "url", FALSE, NULL, &data->profile_url, error);
+        else
+            ok = decode_skip(scanner, error);
+
+        if (!ok) return FALSE;
+    }
+
+    if (*error) return FALSE;
+
+    if (!data->id) return decode_missing("_id", error);
+    if (!data->name) return decode_missing("name", error);
+    if (!data->profile_url) return decode_missing("url", error);
+
+    if (!data->status)
+        data->status = g_strdup(_("Untitled broadcast"));
+
+    return TRUE;
+}
+
+GtChannelData*
+gt_twitch_decode_stream(GtJsonScanner* scanner, GError** error)
+{
+    GtChannelData* data = gt_channel_data_new();
+    const gchar* name = NULL;
+    gboolean channel = FALSE;
+    gboolean viewers = FALSE;
+
+    while (gt_json_scanner_next_member(scanner, &name, error))
+    {
+        gboolean ok;
+
+        if (STRING_EQUALS(name, "channel"))
+        {
+            ok = decode_object(scanner, "channel", error) &&
+                decode_channel(scanner, data, error);
+            channel = TRUE;
+        }
+        else if (STRING_EQUALS(name, "game"))
+            ok = decode_string(scanner, "game", TRUE, NULL, &data->game, error);
+        else if (STRING_EQUALS(name, "viewers"))
+        {
+            ok = decode_int(scanner, "viewers", &data->viewers, error);
+            viewers = TRUE;
+        }
+        else if (STRING_EQUALS(name, "created_at"))
+        {
+            gchar* created_at = NULL;
+
+            ok = decode_string(scanner, "created_at", FALSE, NULL, &created_at, error);
+
+            if (ok)
+            {
+                g_clear_pointer(&data->stream_started_time, g_date_time_unref);
+                data->stream_started_time = parse_time(created_at);
+            }
+
+            g_free(created_at);
+        }
+        else if (STRING_EQUALS(name, "preview"))
+            ok = decode_large_image(scanner, "preview", &data->preview_url, error);
+        else
+            ok = decode_skip(scanner, error);
+
+        if (!ok) goto error;
+    }
+
+    if (*error) goto error;
+
+    if (!channel) { decode_missing("channel", error); goto error; }
+    if (!viewers) { decode_missing("viewers", error); goto error; }
+    if (!data->stream_started_time) { decode_missing("created_at", error); goto error; }
+    if (!data->preview_url) { decode_missing("preview", error); goto error; }
+
+    data->online = TRUE;
+
+    return data;
+
+error:
+    gt_channel_data_free(data);
+
+    return NULL;
+}
+
+/* NOTE: Expects the object to have been opened already */
+GtGameData*
+gt_twitch_decode_game(GtJsonScanner* scanner, GError** error)
 {
     GtGameData* data = gt_game_data_new();
+    const gchar* name = NULL;
 
-    //NOTE: Same hack as above for channel
-    READ_JSON_MEMBER("_id");
-    JsonNode* node = json_reader_get_value(reader);
-    if (STRING_EQUALS(json_node_type_name(node), "Integer"))
-        data->id = g_strdup_printf("%" G_GINT64_FORMAT, json_reader_get_int_value(reader));
-    else if (STRING_EQUALS(json_node_type_name(node), "String"))
-        data->id = g_strdup(json_reader_get_string_value(reader));
-    else
-        g_assert_not_reached();
-    END_JSON_MEMBER();
+    while (gt_json_scanner_next_member(scanner, &name, error))
+    {
+        gboolean ok;
+
+        if (STRING_EQUALS(name, "_id"))
+            ok = decode_id(scanner, "_id", &data->id, error);
+        else if (STRING_EQUALS(name, "name"))
+            ok = decode_string(scanner, "name", FALSE, NULL, &data->name, error);
+        else if (STRING_EQUALS(name, "box"))
+            ok = decode_large_image(scanner, "box", &data->preview_url, error);
+        else if (STRING_EQUALS(name, "logo"))
+            ok = decode_large_image(scanner, "logo", &data->logo_url, error);
+        else
+            ok = decode_skip(scanner, error);
 
-    READ_JSON_VALUE("name", data->name);
-    READ_JSON_MEMBER("box");
-    READ_JSON_VALUE("large", data->preview_url);
-    END_JSON_MEMBER();
-    READ_JSON_MEMBER("logo");
-    READ_JSON_VALUE("large", data->logo_url);
-    END_JSON_MEMBER();
+        if (!ok) goto error;
+    }
+
+    if (*error) goto error;
+
+    if (!data->id) { decode_missing("_id", error); goto error; }
+    if (!data->name) { decode_missing("name", error); goto error; }
+    if (!data->preview_url) { decode_missing("box", error); goto error; }
+    if (!data->logo_url) { decode_missing("logo", error); goto error; }
 
     return data;
 
@@ -572,8 +2092,109 @@ error:
     return NULL;
 }
 
-GtTwitchStreamAccessToken*
-gt_twitch_stream_access_token(GtTwitch* self, const gchar* channel, GError** error)
+/* NOTE: The token is itself a JSON document, its expiry is the only
+ * thing in it we care about */
+static gint64
+decode_access_token_expiry(const gchar* token)
+{
+    GtJsonScanner scanner;
+    const gchar* name = NULL;
+    gint64 ret = 0;
+    GError* err = NULL;
+
+    gt_json_scanner_init(&scanner, token, strlen(token));
+
+    if (!decode_object(&scanner, "token", &err))
+        goto finish;
+
+    while (gt_json_scanner_next_member(&scanner, &name, &err))
+    {
+        if (STRING_EQUALS(name, "expires"))
+        {
+            if (!decode_int(&scanner, name, &ret, &err))
+                break;
+        }
+        else if (!decode_skip(&scanner, &err))
+            break;
+    }
+
+finish:
+    if (err)
+    {
+        WARNINGF("Unable to read access token expiry because: %s", err->message);
+
+        g_error_free(err);
+    }
+
+    gt_json_scanner_clear(&scanner);
+
+    return ret;
+}
+
+/* NOTE: Hands back copies of whatever is still valid for the channel,
+ * the token without streams when the playlist couldn't be fetched */
+static gboolean
+playlist_cache_lookup(const gchar* channel,
+    GtTwitchStreamAccessToken** token, GList** streams)
+{
+    PlaylistCacheEntry* entry = NULL;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    gboolean ret = FALSE;
+
+    g_mutex_lock(&playlist_mutex);
+
+    entry = g_hash_table_lookup(playlist_cache, channel);
+
+    if (entry && entry->expires - PLAYLIST_EXPIRY_MARGIN > now)
+    {
+        if (token) *token = stream_access_token_copy(entry->token);
+        *streams = stream_data_list_copy(entry->streams);
+        ret = TRUE;
+
+        //NOTE: Only the first use of a prefetched playlist is a hit
+        if (entry->prefetched && entry->streams)
+        {
+            prefetch_hits++;
+            entry->prefetched = FALSE;
+
+            INFOF("Prefetched playlist for channel '%s' saved %" G_GINT64_FORMAT "ms, hit rate %d/%d",
+                channel, entry->fetch_time / 1000, prefetch_hits, prefetches_sent);
+        }
+    }
+    else if (entry)
+        g_hash_table_remove(playlist_cache, channel);
+
+    g_mutex_unlock(&playlist_mutex);
+
+    return ret;
+}
+
+static void
+playlist_cache_store(const gchar* channel, const GtTwitchStreamAccessToken* token,
+    GList* streams, gint64 fetch_time, gboolean prefetched)
+{
+    PlaylistCacheEntry* entry = g_slice_new0(PlaylistCacheEntry);
+
+    entry->token = stream_access_token_copy(token);
+    entry->expires = decode_access_token_expiry(token->token);
+    entry->streams = stream_data_list_copy(streams);
+    entry->fetch_time = fetch_time;
+    entry->prefetched = prefetched;
+
+    //NOTE: Don't trust a token we couldn't read the expiry from for long
+    if (entry->expires <= 0)
+        entry->expires = g_get_real_time() / G_USEC_PER_SEC + PLAYLIST_DEFAULT_LIFETIME;
+
+    g_mutex_lock(&playlist_mutex);
+
+    g_hash_table_replace(playlist_cache, g_strdup(channel), entry);
+
+    g_mutex_unlock(&playlist_mutex);
+}
+
+static GtTwitchStreamAccessToken*
+fetch_access_token(GtTwitch* self, const gchar* channel,
+    RequestPriority priority, GError** error)
 {
     g_assert(GT_IS_TWITCH(self));
     g_assert_false(utils_str_empty(channel));
@@ -588,6 +2209,8 @@ gt_twitch_stream_access_token(GtTwitch* self, const gchar* channel, GError** err
 
     msg = soup_message_new("GET", uri);
 
+    set_message_priority(msg, priority);
+
     reader = new_send_message_json(self, msg, &err);
 
     CHECK_AND_PROPAGATE_ERROR("Error getting stream access token for channel '%s'",
@@ -606,8 +2229,15 @@ error:
     return NULL;
 }
 
-GList*
-gt_twitch_all_streams(GtTwitch* self, const gchar* channel, GError** error)
+GtTwitchStreamAccessToken*
+gt_twitch_stream_access_token(GtTwitch* self, const gchar* channel, GError** error)
+{
+    return fetch_access_token(self, channel, REQUEST_PRIORITY_HIGH, error);
+}
+
+static GList*
+fetch_all_streams(GtTwitch* self, const gchar* channel,
+    RequestPriority priority, gboolean prefetch, GError** error)
 {
     g_assert(GT_IS_TWITCH(self));
     g_assert_false(utils_str_empty(channel));
@@ -615,32 +2245,181 @@ gt_twitch_all_streams(GtTwitch* self, const gchar* channel, GError** error)
     g_autoptr(SoupMessage) msg = NULL;
     g_autofree gchar* uri = NULL;
     GtTwitchStreamAccessToken* token = NULL;
+    gint64 start = g_get_monotonic_time();
     GList* ret = NULL;
     GError* err = NULL;
 
-    token = gt_twitch_stream_access_token(self, channel, &err);
+    if (playlist_cache_lookup(channel, &token, &ret))
+    {
+        if (ret)
+        {
+            DEBUGF("Using cached playlist for channel '%s'", channel);
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to get streams for channel '%s'",
-        channel);
+            goto finish;
+        }
+
+        DEBUGF("Using cached access token for channel '%s'", channel);
+    }
+    else
+    {
+        token = fetch_access_token(self, channel, priority, &err);
+
+        CHECK_AND_PROPAGATE_ERROR("Unable to get streams for channel '%s'",
+            channel);
+    }
 
     uri = g_strdup_printf(STREAM_PLAYLIST_URI, channel,
         token->token, token->sig, g_random_int_range(0, 999999));
 
-    gt_twitch_stream_access_token_free(token);
-
     msg = soup_message_new("GET", uri);
 
+    set_message_priority(msg, priority);
+
     new_send_message(self, msg, &err);
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to get all streams for channel '%s'",
-        channel);
+    if (err)
+    {
+        WARNINGF("Unable to get all streams for channel '%s' because: %s",
+            channel, err->message);
+
+        //NOTE: Keep the token around, an offline channel might come back
+        playlist_cache_store(channel, token, NULL, 0, FALSE);
+
+        g_propagate_prefixed_error(error, err,
+            "Unable to get all streams for channel '%s' because: ", channel);
+
+        goto finish;
+    }
 
     ret = parse_playlist(msg->response_body->data);
 
+    playlist_cache_store(channel, token, ret,
+        g_get_monotonic_time() - start, prefetch);
+
+finish:
+    if (token) gt_twitch_stream_access_token_free(token);
+
+    return ret;
+
 error:
+    return NULL;
+}
+
+GList*
+gt_twitch_all_streams(GtTwitch* self, const gchar* channel, GError** error)
+{
+    return fetch_all_streams(self, channel, REQUEST_PRIORITY_HIGH, FALSE, error);
+}
+
+/* NOTE: Only looks in the cache, returns NULL if the channel's
+ * playlist hasn't been fetched or has expired */
+GList*
+gt_twitch_cached_streams(GtTwitch* self, const gchar* channel)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_false(utils_str_empty(channel));
+
+    GList* ret = NULL;
+
+    playlist_cache_lookup(channel, NULL, &ret);
+
     return ret;
 }
 
+/* NOTE: Drops the channel's cached token and playlist so the next
+ * fetch goes to Twitch, the cached variants may be dead by now */
+void
+gt_twitch_forget_cached_streams(GtTwitch* self, const gchar* channel)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_false(utils_str_empty(channel));
+
+    g_mutex_lock(&playlist_mutex);
+    g_hash_table_remove(playlist_cache, channel);
+    g_mutex_unlock(&playlist_mutex);
+}
+
+static void
+prefetch_streams_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    GenericTaskData* data = task_data;
+    GList* streams = NULL;
+    GError* err = NULL;
+
+    streams = fetch_all_streams(GT_TWITCH(source), data->str_1,
+        REQUEST_PRIORITY_LOW, TRUE, &err);
+
+    if (err)
+    {
+        DEBUGF("Unable to prefetch streams for channel '%s' because: %s",
+            data->str_1, err->message);
+
+        g_error_free(err);
+    }
+
+    gt_twitch_stream_data_list_free(streams);
+
+    g_mutex_lock(&playlist_mutex);
+    g_hash_table_remove(prefetch_pending, data->str_1);
+    g_mutex_unlock(&playlist_mutex);
+}
+
+/* NOTE: Speculatively fetches the access token and playlist of a
+ * channel so opening it doesn't have to wait on either */
+void
+gt_twitch_prefetch_streams(GtTwitch* self, const gchar* channel)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_false(utils_str_empty(channel));
+
+    PlaylistCacheEntry* entry = NULL;
+    GenericTaskData* data = NULL;
+    GTask* task = NULL;
+    gint64 now = g_get_monotonic_time();
+    gboolean queue = FALSE;
+
+    g_mutex_lock(&playlist_mutex);
+
+    if (now - prefetch_window_start > PREFETCH_WINDOW)
+    {
+        prefetch_window_start = now;
+        prefetch_window_count = 0;
+    }
+
+    entry = g_hash_table_lookup(playlist_cache, channel);
+
+    queue = prefetch_window_count < PREFETCH_BUDGET &&
+        !g_hash_table_contains(prefetch_pending, channel) &&
+        !(entry && entry->streams &&
+            entry->expires - PLAYLIST_EXPIRY_MARGIN > g_get_real_time() / G_USEC_PER_SEC);
+
+    if (queue)
+    {
+        prefetch_window_count++;
+        prefetches_sent++;
+        g_hash_table_add(prefetch_pending, g_strdup(channel));
+    }
+
+    g_mutex_unlock(&playlist_mutex);
+
+    if (!queue)
+        return;
+
+    DEBUGF("Prefetching streams for channel '%s'", channel);
+
+    task = g_task_new(self, NULL, NULL, NULL);
+
+    data = generic_task_data_new();
+    data->str_1 = g_strdup(channel);
+
+    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
+
+    run_in_request_pool(task, prefetch_streams_cb);
+
+    g_object_unref(task);
+}
+
 static void
 all_streams_cb(GTask* task, gpointer source,
     gpointer task_data, GCancellable* cancel)
@@ -682,7 +2461,7 @@ gt_twitch_all_streams_async(GtTwitch* self, const gchar* channel,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, all_streams_cb);
+    run_in_request_pool(task, all_streams_cb);
 }
 
 GList*
@@ -718,7 +2497,57 @@ gt_twitch_stream_list_filter_quality(GList* list,
         g_assert_nonnull(ret);
     }
 
-    return ret;
+    return ret;
+}
+
+static gpointer
+decode_top_channels(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
+{
+    gint n = params->int_1;
+    gint offset = params->int_2;
+    const gchar* game = params->str_1;
+    const gchar* name = NULL;
+    GList* ret = NULL;
+    GError* err = NULL;
+
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
+
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        if (!STRING_EQUALS(name, "streams"))
+        {
+            if (!decode_skip(scanner, &err)) break;
+
+            continue;
+        }
+
+        if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+            break;
+
+        while (decode_next_object(scanner, "streams", &err))
+        {
+            GtChannelData* data = gt_twitch_decode_stream(scanner, &err);
+
+            if (!data) break;
+
+            ret = g_list_prepend(ret, gt_channel_new(data));
+        }
+
+        if (err) break;
+    }
+
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to fetch top channels with amount '%d', offset '%d' and game '%s'",
+        n, offset, game);
+
+    return g_list_reverse(ret);
+
+error:
+    gt_channel_list_free(ret);
+
+    return NULL;
 }
 
 GList*
@@ -733,75 +2562,25 @@ gt_twitch_top_channels(GtTwitch* self, gint n, gint offset,
     g_assert_nonnull(language);
 
     g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GBytes) body = NULL;
     g_autofree gchar* uri = NULL;
-    GList* ret = NULL;
+    GenericTaskData params = {.int_1 = n, .int_2 = offset, .str_1 = (gchar*) game};
     GError* err = NULL;
 
     uri = g_strdup_printf(TOP_CHANNELS_URI, n, offset, game, language);
 
     msg = soup_message_new("GET", uri);
 
-    reader = new_send_message_json(self, msg, &err);
+    body = new_send_message_body(self, msg, TWITCH_API_VERSION_5, NULL, &err);
 
     CHECK_AND_PROPAGATE_ERROR("Unable to fetch top channels with amount '%d', offset '%d' and game '%s'",
         n, offset, game);
 
-    READ_JSON_MEMBER("streams");
-
-    for (gint i = 0; i < json_reader_count_elements(reader); i++)
-    {
-        GtChannel* channel = NULL;
-        GtChannelData* data = NULL;
-
-        READ_JSON_ELEMENT(i);
-
-        data = parse_stream(reader, &err);
-
-        CHECK_AND_PROPAGATE_ERROR("Unable to fetch top channels with amount '%d', offset '%d' and game '%s'",
-            n, offset, game);
-
-        channel = gt_channel_new(data);
-
-        END_JSON_ELEMENT();
-
-        ret = g_list_append(ret, channel);
-    }
-
-    END_JSON_MEMBER();
-
-    return ret;
+    return decode_json_response(self, body, decode_top_channels, &params, error);
 
 error:
-    gt_channel_list_free(ret);
-
     return NULL;
 }
-static void
-top_channels_async_cb(GTask* task,
-                      gpointer source,
-                      gpointer task_data,
-                      GCancellable* cancel)
-{
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
-
-    GenericTaskData* data = task_data;
-    GList* ret = NULL;
-    GError* err = NULL;
-
-    if (g_task_return_error_if_cancelled(task))
-        return;
-
-    ret = gt_twitch_top_channels(GT_TWITCH(source), data->int_1, data->int_2,
-        data->str_1, data->str_2, &err);
-
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) gt_channel_list_free);
-}
 
 void
 gt_twitch_top_channels_async(GtTwitch* self, gint n, gint offset, const gchar* game,
@@ -814,6 +2593,8 @@ gt_twitch_top_channels_async(GtTwitch* self, gint n, gint offset, const gchar* g
     g_assert_nonnull(game);
     g_assert_nonnull(language);
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
     GTask* task = NULL;
     GenericTaskData* data = NULL;
 
@@ -828,7 +2609,12 @@ gt_twitch_top_channels_async(GtTwitch* self, gint n, gint offset, const gchar* g
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, top_channels_async_cb);
+    uri = g_strdup_printf(TOP_CHANNELS_URI, n, offset, game, language);
+
+    msg = soup_message_new("GET", uri);
+
+    send_message_decode_async(self, msg, task,
+        decode_top_channels, (GDestroyNotify) gt_channel_list_free);
 
     g_object_unref(task);
 }
@@ -845,61 +2631,81 @@ gt_twitch_top_channels_finish(GtTwitch* self,
     return ret;
 }
 
-GList*
-gt_twitch_top_games(GtTwitch* self,
-    gint n, gint offset, GError** error)
+static gpointer
+decode_top_games(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_cmpint(n, >=, 0);
-    g_assert_cmpint(n, <=, 100);
-    g_assert_cmpint(offset, >=, 0);
-
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader = NULL;
-    g_autofree gchar* uri = NULL;
+    gint n = params->int_1;
+    gint offset = params->int_2;
+    const gchar* name = NULL;
     GList* ret = NULL;
     GError* err = NULL;
 
-    uri = g_strdup_printf(TOP_GAMES_URI, n, offset);
-
-    msg = soup_message_new("GET", uri);
-
-    reader = new_send_message_json(self, msg, &err);
-
-    CHECK_AND_PROPAGATE_ERROR("Unable to get top games with amount '%d' and offset '%d'",
-        n, offset);
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
 
-    READ_JSON_MEMBER("top");
-
-    for (gint i = 0; i < json_reader_count_elements(reader); i++)
+    while (gt_json_scanner_next_member(scanner, &name, &err))
     {
-        GtGame* game = NULL;
-        GtGameData* data = NULL;
+        if (!STRING_EQUALS(name, "top"))
+        {
+            if (!decode_skip(scanner, &err)) break;
 
-        READ_JSON_ELEMENT(i);
+            continue;
+        }
 
-        READ_JSON_MEMBER("game");
+        if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+            break;
 
-        data = parse_game(reader, &err);
+        while (decode_next_object(scanner, "top", &err))
+        {
+            GtGameData* data = NULL;
+            gint64 viewers = -1;
+            gint64 channels = 0;
 
-        CHECK_AND_PROPAGATE_ERROR("Unable to get top games with amount '%d' and offset '%d'",
-            n, offset);
+            while (gt_json_scanner_next_member(scanner, &name, &err))
+            {
+                gboolean ok;
 
-        END_JSON_MEMBER();
+                if (STRING_EQUALS(name, "game"))
+                {
+                    gt_game_data_free(data);
+                    data = decode_object(scanner, "game", &err) ?
+                        gt_twitch_decode_game(scanner, &err) : NULL;
+                    ok = data != NULL;
+                }
+                else if (STRING_EQUALS(name, "viewers"))
+                    ok = decode_int(scanner, "viewers", &viewers, &err);
+                else if (STRING_EQUALS(name, "channels"))
+                    ok = decode_int(scanner, "channels", &channels, &err);
+                else
+                    ok = decode_skip(scanner, &err);
+
+                if (!ok) break;
+            }
+
+            if (!err && !data)
+                decode_missing("game", &err);
 
-        READ_JSON_VALUE("viewers", data->viewers);
-        READ_JSON_VALUE("channels", data->channels);
+            if (err)
+            {
+                gt_game_data_free(data);
+                break;
+            }
 
-        game = gt_game_new(data);
+            data->viewers = viewers;
+            data->channels = channels;
 
-        END_JSON_ELEMENT();
+            ret = g_list_prepend(ret, gt_game_new(data));
+        }
 
-        ret = g_list_append(ret, game);
+        if (err) break;
     }
 
-    END_JSON_MEMBER();
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to get top games with amount '%d' and offset '%d'",
+        n, offset);
 
-    return ret;
+    return g_list_reverse(ret);
 
 error:
     gt_game_list_free(ret);
@@ -907,30 +2713,34 @@ error:
     return NULL;
 }
 
-
-static void
-top_games_async_cb(GTask* task,
-                   gpointer source,
-                   gpointer task_data,
-                   GCancellable* cancel)
+GList*
+gt_twitch_top_games(GtTwitch* self,
+    gint n, gint offset, GError** error)
 {
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_cmpint(n, >=, 0);
+    g_assert_cmpint(n, <=, 100);
+    g_assert_cmpint(offset, >=, 0);
 
-    GenericTaskData* data = task_data;
-    GList* ret = NULL;
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(GBytes) body = NULL;
+    g_autofree gchar* uri = NULL;
+    GenericTaskData params = {.int_1 = n, .int_2 = offset};
     GError* err = NULL;
 
-    if (g_task_return_error_if_cancelled(task))
-        return;
+    uri = g_strdup_printf(TOP_GAMES_URI, n, offset);
 
-    ret = gt_twitch_top_games(GT_TWITCH(source), data->int_1, data->int_2, &err);
+    msg = soup_message_new("GET", uri);
 
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) gt_game_list_free);
+    body = new_send_message_body(self, msg, TWITCH_API_VERSION_5, NULL, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to get top games with amount '%d' and offset '%d'",
+        n, offset);
+
+    return decode_json_response(self, body, decode_top_games, &params, error);
+
+error:
+    return NULL;
 }
 
 void
@@ -944,6 +2754,8 @@ gt_twitch_top_games_async(GtTwitch* self, gint n, gint offset,
     g_assert_cmpint(n, <=, 100);
     g_assert_cmpint(offset, >=, 0);
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
     GTask* task = NULL;
     GenericTaskData* data = NULL;
 
@@ -956,7 +2768,12 @@ gt_twitch_top_games_async(GtTwitch* self, gint n, gint offset,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, top_games_async_cb);
+    uri = g_strdup_printf(TOP_GAMES_URI, n, offset);
+
+    msg = soup_message_new("GET", uri);
+
+    send_message_decode_async(self, msg, task,
+        decode_top_games, (GDestroyNotify) gt_game_list_free);
 
     g_object_unref(task);
 }
@@ -973,6 +2790,213 @@ gt_twitch_top_games_finish(GtTwitch* self,
     return ret;
 }
 
+#define SEARCH_AMOUNT 100
+
+static gpointer
+decode_search_page(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
+{
+    const gchar* query = params->str_1;
+    gint page = params->int_1;
+    gboolean offline = params->bool_1;
+    const gchar* array = offline ? "channels" : "streams";
+    const gchar* name = NULL;
+    GPtrArray* ret = g_ptr_array_new_with_free_func((GDestroyNotify) gt_channel_data_free);
+    GError* err = NULL;
+
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
+
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        if (!STRING_EQUALS(name, array))
+        {
+            if (!decode_skip(scanner, &err)) break;
+
+            continue;
+        }
+
+        if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+            break;
+
+        while (decode_next_object(scanner, array, &err))
+        {
+            GtChannelData* data = NULL;
+
+            if (offline)
+            {
+                data = gt_channel_data_new();
+
+                if (!decode_channel(scanner, data, &err))
+                    g_clear_pointer(&data, gt_channel_data_free);
+            }
+            else
+                data = gt_twitch_decode_stream(scanner, &err);
+
+            if (!data) break;
+
+            g_ptr_array_add(ret, data);
+        }
+
+        if (err) break;
+    }
+
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to search channels with query '%s' and page '%d'",
+        query, page);
+
+    return ret;
+
+error:
+    g_ptr_array_unref(ret);
+
+    return NULL;
+}
+
+/* NOTE: Pages are kept until the query changes, so a new query or
+ * offline flag throws away everything cached for the previous one */
+static GPtrArray*
+search_page_lookup(GtTwitch* self, const gchar* query, gboolean offline, gint page)
+{
+    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
+    GPtrArray* ret = NULL;
+
+    g_mutex_lock(&priv->search_mutex);
+
+    if (!STRING_EQUALS(priv->search_query, query) || priv->search_offline != offline)
+    {
+        g_free(priv->search_query);
+        priv->search_query = g_strdup(query);
+        priv->search_offline = offline;
+        priv->search_prefetch_page = -1;
+
+        g_hash_table_remove_all(priv->search_pages);
+    }
+    else if ((ret = g_hash_table_lookup(priv->search_pages, GINT_TO_POINTER(page))))
+        g_ptr_array_ref(ret);
+
+    g_mutex_unlock(&priv->search_mutex);
+
+    return ret;
+}
+
+static void
+search_page_store(GtTwitch* self, const gchar* query, gboolean offline, gint page, GPtrArray* channels)
+{
+    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
+
+    g_mutex_lock(&priv->search_mutex);
+
+    //NOTE: Don't let a slow response for an old query pollute the cache
+    if (channels && STRING_EQUALS(priv->search_query, query) && priv->search_offline == offline)
+    {
+        g_hash_table_replace(priv->search_pages, GINT_TO_POINTER(page),
+            g_ptr_array_ref(channels));
+    }
+
+    if (priv->search_prefetch_page == page)
+        priv->search_prefetch_page = -1;
+
+    g_mutex_unlock(&priv->search_mutex);
+}
+
+static GPtrArray*
+search_page_fetch(GtTwitch* self, const gchar* query, gboolean offline, gint page,
+    RequestPriority priority, GError** error)
+{
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(GBytes) body = NULL;
+    g_autofree gchar* uri = NULL;
+    GenericTaskData params = {.int_1 = page, .str_1 = (gchar*) query, .bool_1 = offline};
+    GPtrArray* ret = NULL;
+    GError* err = NULL;
+
+    ret = search_page_lookup(self, query, offline, page);
+
+    if (ret)
+        return ret;
+
+    uri = g_strdup_printf(offline ? SEARCH_CHANNELS_URI : SEARCH_STREAMS_URI,
+        query, SEARCH_AMOUNT, page * SEARCH_AMOUNT);
+
+    msg = soup_message_new("GET", uri);
+
+    set_message_priority(msg, priority);
+
+    body = new_send_message_body(self, msg, TWITCH_API_VERSION_5, NULL, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to search channels with query '%s' and page '%d'",
+        query, page);
+
+    ret = decode_json_response(self, body, decode_search_page, &params, error);
+
+    if (ret)
+        search_page_store(self, query, offline, page, ret);
+
+    return ret;
+
+error:
+    return NULL;
+}
+
+static void
+search_page_prefetch_cb(GTask* task, gpointer source,
+    gpointer task_data, GCancellable* cancel)
+{
+    GenericTaskData* data = task_data;
+    g_autoptr(GPtrArray) channels = NULL;
+    g_autoptr(GError) err = NULL;
+
+    channels = search_page_fetch(GT_TWITCH(source), data->str_1, data->bool_1, data->int_1,
+        REQUEST_PRIORITY_NORMAL, &err);
+
+    if (err)
+    {
+        DEBUGF("Unable to prefetch search page '%d' for query '%s' because: %s",
+            data->int_1, data->str_1, err->message);
+
+        search_page_store(GT_TWITCH(source), data->str_1, data->bool_1, data->int_1, NULL);
+    }
+}
+
+static void
+search_page_prefetch(GtTwitch* self, const gchar* query, gboolean offline, gint page)
+{
+    GtTwitchPrivate* priv = gt_twitch_get_instance_private(self);
+    GenericTaskData* data = NULL;
+    GTask* task = NULL;
+    gboolean queue = FALSE;
+
+    g_mutex_lock(&priv->search_mutex);
+
+    queue = STRING_EQUALS(priv->search_query, query) && priv->search_offline == offline &&
+        priv->search_prefetch_page != page &&
+        !g_hash_table_contains(priv->search_pages, GINT_TO_POINTER(page));
+
+    if (queue)
+        priv->search_prefetch_page = page;
+
+    g_mutex_unlock(&priv->search_mutex);
+
+    if (!queue)
+        return;
+
+    DEBUGF("Prefetching search page '%d' for query '%s'", page, query);
+
+    task = g_task_new(self, NULL, NULL, NULL);
+
+    data = generic_task_data_new();
+    data->int_1 = page;
+    data->str_1 = g_strdup(query);
+    data->bool_1 = offline;
+
+    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
+
+    run_in_request_pool(task, search_page_prefetch_cb);
+
+    g_object_unref(task);
+}
+
 //NOTE: Twitch's stream search API is retarted (see https://github.com/justintv/Twitch-API/issues/513)
 //so we need to do this hack to get anything remotely usable. It will return duplicates unless
 //amount=offset*k where k is some multiple, i.e. it works in 'pages'
@@ -985,60 +3009,36 @@ gt_twitch_search_channels(GtTwitch* self, const gchar* query, gint n, gint offse
     g_assert_cmpint(offset, >=, 0);
     g_assert_false(utils_str_empty(query));
 
-#define SEARCH_AMOUNT 100
-
     const gint PAGE_AMOUNT = offline ? 100 : 90;
 
     MESSAGEF("Searching for channels with query '%s', amount '%d' ('%d') and offset '%d' ('%d')",
         query, 100, SEARCH_AMOUNT, (offset / PAGE_AMOUNT) * 100, offset);
 
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader = NULL;
-    g_autofree gchar* uri = NULL;
-    gint total;
+    g_autoptr(GPtrArray) channels = NULL;
+    gint page = offset / PAGE_AMOUNT;
+    gint start = offset % PAGE_AMOUNT;
+    gint end;
     GList* ret = NULL;
     GError* err = NULL;
 
-    uri = g_strdup_printf(offline ? SEARCH_CHANNELS_URI : SEARCH_STREAMS_URI,
-        query, SEARCH_AMOUNT, (offset / PAGE_AMOUNT) * SEARCH_AMOUNT);
-
-    msg = soup_message_new("GET", uri);
-
-    reader = new_send_message_json(self, msg, &err);
+    channels = search_page_fetch(self, query, offline, page, REQUEST_PRIORITY_HIGH, &err);
 
     CHECK_AND_PROPAGATE_ERROR("Unable to search channels with query '%s', amount '%d' ('%d') and offset '%d' ('%d')",
         query, PAGE_AMOUNT, SEARCH_AMOUNT, (offset / PAGE_AMOUNT) * PAGE_AMOUNT, offset);
 
-    READ_JSON_MEMBER(offline ? "channels" : "streams");
-
-    total = MIN(n + offset % PAGE_AMOUNT, json_reader_count_elements(reader));
-
-    for (gint i = offset % PAGE_AMOUNT; i < total; i++)
-    {
-        GtChannel* channel = NULL;
-        GtChannelData* data = NULL;
-
-        READ_JSON_ELEMENT(i);
-
-        data = offline ? parse_channel(reader, &err) : parse_stream(reader, &err);
-
-        CHECK_AND_PROPAGATE_ERROR("Unable to search channels with query '%s', amount '%d' ('%d') and offset '%d' ('%d')",
-            query, PAGE_AMOUNT, SEARCH_AMOUNT, (offset / PAGE_AMOUNT) * PAGE_AMOUNT, offset);
+    end = MIN(start + n, (gint) channels->len);
 
-        channel = gt_channel_new(data);
-
-        END_JSON_ELEMENT();
-
-        ret = g_list_append(ret, channel);
-    }
+    for (gint i = start; i < end; i++)
+        ret = g_list_prepend(ret, gt_channel_new(gt_channel_data_copy(g_ptr_array_index(channels, i))));
 
-    json_reader_end_member(reader);
+    /* NOTE: Get the next page going once we're halfway through this
+     * one, a short page means there's nothing more to fetch */
+    if (end >= PAGE_AMOUNT / 2 && channels->len >= SEARCH_AMOUNT)
+        search_page_prefetch(self, query, offline, page + 1);
 
-    return ret;
+    return g_list_reverse(ret);
 
 error:
-    gt_channel_list_free(ret);
-
     return NULL;
 }
 
@@ -1090,7 +3090,7 @@ gt_twitch_search_channels_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, search_channels_async_cb);
+    run_in_request_pool(task, search_channels_async_cb);
 
     g_object_unref(task);
 }
@@ -1108,56 +3108,60 @@ gt_twitch_search_channels_finish(GtTwitch* self,
     return ret;
 }
 
-GList*
-gt_twitch_search_games(GtTwitch* self,
-    const gchar* query, gint n, gint offset,
-    GError** error)
+static gpointer
+decode_search_games(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_cmpint(n, >=, 0);
-    g_assert_cmpint(n, <=, 100);
-    g_assert_cmpint(offset, >=, 0);
-    g_assert_false(utils_str_empty(query));
-
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader = NULL;
-    g_autofree gchar* uri = NULL;
+    const gchar* query = params->str_1;
+    gint n = params->int_1;
+    gint offset = params->int_2;
+    const gchar* name = NULL;
     GList* ret = NULL;
     GError* err = NULL;
 
-    uri = g_strdup_printf(SEARCH_GAMES_URI, query);
-
-    msg = soup_message_new("GET", uri);
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
 
-    reader = new_send_message_json(self, msg, &err);
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        GtJsonToken token;
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to search games with query '%s', amount '%d' and offset '%d'",
-        query, n, offset);
+        if (!STRING_EQUALS(name, "games"))
+        {
+            if (!decode_skip(scanner, &err)) break;
 
-    READ_JSON_MEMBER("games");
+            continue;
+        }
 
-    for (gint i = 0; i < json_reader_count_elements(reader); i++)
-    {
-        GtGame* game;
-        GtGameData* data = NULL;
+        token = gt_json_scanner_next(scanner, &err);
 
-        READ_JSON_ELEMENT(i);
+        //NOTE: Twitch sends null instead of an empty array when nothing matches
+        if (token == GT_JSON_TOKEN_NULL)
+            continue;
 
-        data = parse_game(reader, &err);
+        if (token != GT_JSON_TOKEN_ARRAY_START)
+        {
+            decode_unexpected(token, "games", &err);
+            break;
+        }
 
-        CHECK_AND_PROPAGATE_ERROR("Unable to search games with query '%s', amount '%d' and offset '%d'",
-            query, n, offset);
+        while (decode_next_object(scanner, "games", &err))
+        {
+            GtGameData* data = gt_twitch_decode_game(scanner, &err);
 
-        game = gt_game_new(data);
+            if (!data) break;
 
-        END_JSON_ELEMENT();
+            ret = g_list_prepend(ret, gt_game_new(data));
+        }
 
-        ret = g_list_append(ret, game);
+        if (err) break;
     }
 
-    END_JSON_MEMBER();
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to search games with query '%s', amount '%d' and offset '%d'",
+        query, n, offset);
 
-    return ret;
+    return g_list_reverse(ret);
 
 error:
     gt_game_list_free(ret);
@@ -1165,27 +3169,36 @@ error:
     return NULL;
 }
 
-
-static void
-search_games_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
+GList*
+gt_twitch_search_games(GtTwitch* self,
+    const gchar* query, gint n, gint offset,
+    GError** error)
 {
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_cmpint(n, >=, 0);
+    g_assert_cmpint(n, <=, 100);
+    g_assert_cmpint(offset, >=, 0);
+    g_assert_false(utils_str_empty(query));
 
-    GenericTaskData* data = task_data;
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(GBytes) body = NULL;
+    g_autofree gchar* uri = NULL;
+    GenericTaskData params = {.int_1 = n, .int_2 = offset, .str_1 = (gchar*) query};
+    GError* err = NULL;
 
-    if (g_task_return_error_if_cancelled(task))
-        return;
+    uri = g_strdup_printf(SEARCH_GAMES_URI, query);
 
-    GError* err = NULL;
-    GList* ret = gt_twitch_search_games(GT_TWITCH(source), data->str_1, data->int_1, data->int_2, &err);
+    msg = soup_message_new("GET", uri);
 
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) gt_game_list_free);
+    body = new_send_message_body(self, msg, TWITCH_API_VERSION_5, NULL, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to search games with query '%s', amount '%d' and offset '%d'",
+        query, n, offset);
+
+    return decode_json_response(self, body, decode_search_games, &params, error);
+
+error:
+    return NULL;
 }
 
 void
@@ -1200,6 +3213,8 @@ gt_twitch_search_games_async(GtTwitch* self,
     g_assert_cmpint(offset, >=, 0);
     g_assert_false(utils_str_empty(query));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
     GTask* task = NULL;
     GenericTaskData* data = NULL;
 
@@ -1213,7 +3228,12 @@ gt_twitch_search_games_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, search_games_async_cb);
+    uri = g_strdup_printf(SEARCH_GAMES_URI, query);
+
+    msg = soup_message_new("GET", uri);
+
+    send_message_decode_async(self, msg, task,
+        decode_search_games, (GDestroyNotify) gt_game_list_free);
 
     g_object_unref(task);
 }
@@ -1244,8 +3264,8 @@ gt_twitch_stream_data_list_free(GList* list)
     g_list_free_full(list, (GDestroyNotify) gt_twitch_stream_data_free);
 }
 
-GtChannelData*
-gt_twitch_fetch_channel_data(GtTwitch* self, const gchar* id, GError** error)
+static GtChannelData*
+fetch_channel_data(GtTwitch* self, const gchar* id, RequestPriority priority, GError** error)
 {
     g_assert(GT_IS_TWITCH(self));
     g_assert_false(utils_str_empty(id));
@@ -1260,6 +3280,8 @@ gt_twitch_fetch_channel_data(GtTwitch* self, const gchar* id, GError** error)
 
     msg = soup_message_new("GET", uri);
 
+    set_message_priority(msg, priority);
+
     reader = new_send_message_json(self, msg, &err);
 
     CHECK_AND_PROPAGATE_ERROR("Unable to fetch channel data with id '%s'",
@@ -1280,6 +3302,8 @@ gt_twitch_fetch_channel_data(GtTwitch* self, const gchar* id, GError** error)
 
         msg = soup_message_new("GET", uri);
 
+        set_message_priority(msg, priority);
+
         reader = new_send_message_json(self, msg, &err);
 
         CHECK_AND_PROPAGATE_ERROR("Unable to fetch channel data with id '%s'",
@@ -1292,7 +3316,7 @@ gt_twitch_fetch_channel_data(GtTwitch* self, const gchar* id, GError** error)
     }
     else
     {
-        ret = parse_stream(reader, &err);
+        ret = gt_twitch_parse_stream(reader, &err);
 
         CHECK_AND_PROPAGATE_ERROR("Unable to fetch channel data with id '%s'",
             id);
@@ -1309,6 +3333,13 @@ error:
     return NULL;
 }
 
+//NOTE: Only used for refreshing channels in the background
+GtChannelData*
+gt_twitch_fetch_channel_data(GtTwitch* self, const gchar* id, GError** error)
+{
+    return fetch_channel_data(self, id, REQUEST_PRIORITY_LOW, error);
+}
+
 GtChannel*
 gt_twitch_fetch_channel(GtTwitch* self, const gchar* id, GError** error)
 {
@@ -1320,7 +3351,7 @@ gt_twitch_fetch_channel(GtTwitch* self, const gchar* id, GError** error)
 
     DEBUG("Fetching channel with id '%s'", id);
 
-    data = gt_twitch_fetch_channel_data(self, id, error);
+    data = fetch_channel_data(self, id, REQUEST_PRIORITY_HIGH, error);
 
     if (*error)
         return NULL;
@@ -1370,7 +3401,7 @@ gt_twitch_fetch_channel_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, fetch_channel_async_cb);
+    run_in_request_pool(task, fetch_channel_async_cb);
 
     g_object_unref(task);
 }
@@ -1387,6 +3418,150 @@ gt_twitch_fetch_channel_finish(GtTwitch* self,
     return ret;
 }
 
+static gpointer
+decode_live_streams(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
+{
+    const gchar* ids = params->str_1;
+    const gchar* name = NULL;
+    GList* ret = NULL;
+    GError* err = NULL;
+
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
+
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        if (!STRING_EQUALS(name, "streams"))
+        {
+            if (!decode_skip(scanner, &err)) break;
+
+            continue;
+        }
+
+        if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+            break;
+
+        while (decode_next_object(scanner, "streams", &err))
+        {
+            GtChannelData* data = gt_twitch_decode_stream(scanner, &err);
+
+            if (!data) break;
+
+            ret = g_list_prepend(ret, data);
+        }
+
+        if (err) break;
+    }
+
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to fetch live streams for channels with ids '%s'",
+        ids);
+
+    return g_list_reverse(ret);
+
+error:
+    gt_channel_data_list_free(ret);
+
+    return NULL;
+}
+
+static gchar*
+join_live_stream_ids(GList* ids)
+{
+    GString* ret = g_string_new(NULL);
+
+    g_assert_cmpint(g_list_length(ids), <=, MAX_LIVE_STREAMS_IDS);
+
+    for (GList* l = ids; l != NULL; l = l->next)
+    {
+        if (l != ids)
+            g_string_append_c(ret, ',');
+
+        g_string_append(ret, l->data);
+    }
+
+    return g_string_free(ret, FALSE);
+}
+
+/* NOTE: Takes up to 100 channel ids and returns the data of the ones
+ * that are live in a single request, the rest are simply left out */
+GList*
+gt_twitch_fetch_live_streams(GtTwitch* self, GList* ids, GError** error)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_nonnull(ids);
+
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(GBytes) body = NULL;
+    g_autofree gchar* uri = NULL;
+    g_autofree gchar* joined = join_live_stream_ids(ids);
+    GenericTaskData params = {.str_1 = joined};
+    GError* err = NULL;
+
+    uri = g_strdup_printf(LIVE_STREAMS_URI, joined, MAX_LIVE_STREAMS_IDS);
+
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    set_message_priority(msg, REQUEST_PRIORITY_LOW);
+    g_object_set_data(G_OBJECT(msg), "uncached", GINT_TO_POINTER(TRUE));
+
+    body = new_send_message_body(self, msg, TWITCH_API_VERSION_5, NULL, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to fetch live streams for channels with ids '%s'",
+        joined);
+
+    return decode_json_response(self, body, decode_live_streams, &params, error);
+
+error:
+    return NULL;
+}
+
+void
+gt_twitch_fetch_live_streams_async(GtTwitch* self, GList* ids,
+    GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_nonnull(ids);
+
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
+    GTask* task = NULL;
+    GenericTaskData* data = NULL;
+
+    task = g_task_new(self, cancel, cb, udata);
+    g_task_set_return_on_cancel(task, FALSE);
+
+    data = generic_task_data_new();
+    data->str_1 = join_live_stream_ids(ids);
+
+    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
+
+    uri = g_strdup_printf(LIVE_STREAMS_URI, data->str_1, MAX_LIVE_STREAMS_IDS);
+
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    set_message_priority(msg, REQUEST_PRIORITY_LOW);
+    g_object_set_data(G_OBJECT(msg), "uncached", GINT_TO_POINTER(TRUE));
+
+    send_message_decode_async(self, msg, task,
+        decode_live_streams, (GDestroyNotify) gt_channel_data_list_free);
+
+    g_object_unref(task);
+}
+
+GList*
+gt_twitch_fetch_live_streams_finish(GtTwitch* self,
+    GAsyncResult* result, GError** error)
+{
+    g_assert(GT_IS_TWITCH(self));
+    g_assert(G_IS_ASYNC_RESULT(result));
+
+    GList* ret = g_task_propagate_pointer(G_TASK(result), error);
+
+    return ret;
+}
+
 /* GdkPixbuf* */
 /* gt_twitch_download_picture_new(GtTwitch* self, const gchar* uri, */
 /*     gboolean check_cache, GError** error) */
@@ -1538,7 +3713,7 @@ gt_twitch_download_picture_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, download_picture_async_cb);
+    run_in_request_pool(task, download_picture_async_cb);
 
     g_object_unref(task);
 }
@@ -1808,7 +3983,7 @@ gt_twitch_fetch_chat_badge_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, fetch_chat_badge_async_cb);
+    run_in_request_pool(task, fetch_chat_badge_async_cb);
 
     g_object_unref(task);
 }
@@ -1985,7 +4160,7 @@ gt_twitch_channel_info_async(GtTwitch* self, const gchar* chan,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, channel_info_async_cb);
+    run_in_request_pool(task, channel_info_async_cb);
 
     g_object_unref(task);
 }
@@ -2030,109 +4205,241 @@ error:
     return NULL;
 }
 
-static GList*
-fetch_followed_streams(GtTwitch* self, const gchar* oauth_token,
-    gint limit, gint offset, gint* total, GError** error)
+#define FOLLOWS_LIMIT 100
+
+typedef struct
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_cmpint(limit, >, 0);
-    g_assert_cmpint(offset, >=, 0);
-    g_assert_false(utils_str_empty(oauth_token));
+    gint64 total;
+    GList* channels;
+} FollowsPage;
 
-    g_autoptr(SoupMessage) msg;
-    g_autoptr(JsonReader) reader;
-    g_autofree gchar* uri;
-    GList* ret = NULL;
+typedef struct
+{
+    GtTwitch* self;
+    const gchar* id;
+    const gchar* oauth_token;
+    gint pending;
+    GError* error;
+    GList* streams;
+    GList* chans;
+} FollowsFetch;
+
+static void
+follows_page_free(FollowsPage* page)
+{
+    if (!page) return;
+
+    gt_channel_data_list_free(page->channels);
+
+    g_slice_free(FollowsPage, page);
+}
+
+static gpointer
+decode_followed_streams(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
+{
+    const gchar* oauth_token = params->str_1;
+    gint limit = params->int_1;
+    gint offset = params->int_2;
+    const gchar* name = NULL;
+    FollowsPage* ret = g_slice_new0(FollowsPage);
     GError* err = NULL;
 
-    uri = g_strdup_printf(FOLLOWED_STREAMS_URI, limit, offset, oauth_token);
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
 
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        if (STRING_EQUALS(name, "_total"))
+        {
+            if (!decode_int(scanner, "_total", &ret->total, &err)) break;
+        }
+        else if (STRING_EQUALS(name, "streams"))
+        {
+            if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+                break;
 
-    reader = new_send_message_json(self, msg, &err);
+            while (decode_next_object(scanner, "streams", &err))
+            {
+                GtChannelData* data = gt_twitch_decode_stream(scanner, &err);
+
+                if (!data) break;
+
+                ret->channels = g_list_prepend(ret->channels, data);
+            }
+
+            if (err) break;
+        }
+        else if (!decode_skip(scanner, &err))
+            break;
+    }
 
+check:
     CHECK_AND_PROPAGATE_ERROR("Unable to fetch followed streams with oauth token '%s', limit '%d' and offset '%d'",
         oauth_token, limit, offset);
 
-    READ_JSON_VALUE("_total", *total);
+    ret->channels = g_list_reverse(ret->channels);
+
+    return ret;
+
+error:
+    follows_page_free(ret);
+
+    return NULL;
+}
+
+static gpointer
+decode_followed_channels(GtTwitch* self, GtJsonScanner* scanner,
+    GenericTaskData* params, GError** error)
+{
+    const gchar* id = params->str_1;
+    gint limit = params->int_1;
+    gint offset = params->int_2;
+    const gchar* name = NULL;
+    FollowsPage* ret = g_slice_new0(FollowsPage);
+    GError* err = NULL;
+
+    if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, &err))
+        goto check;
+
+    while (gt_json_scanner_next_member(scanner, &name, &err))
+    {
+        if (STRING_EQUALS(name, "_total"))
+        {
+            if (!decode_int(scanner, "_total", &ret->total, &err)) break;
+        }
+        else if (STRING_EQUALS(name, "follows"))
+        {
+            if (!gt_json_scanner_expect(scanner, GT_JSON_TOKEN_ARRAY_START, &err))
+                break;
+
+            while (decode_next_object(scanner, "follows", &err))
+            {
+                GtChannelData* data = NULL;
+
+                while (gt_json_scanner_next_member(scanner, &name, &err))
+                {
+                    gboolean ok;
+
+                    if (STRING_EQUALS(name, "channel"))
+                    {
+                        gt_channel_data_free(data);
+                        data = gt_channel_data_new();
+
+                        ok = decode_object(scanner, "channel", &err) &&
+                            decode_channel(scanner, data, &err);
+                    }
+                    else
+                        ok = decode_skip(scanner, &err);
 
-    READ_JSON_MEMBER("streams");
+                    if (!ok) break;
+                }
 
-    for (gint i = 0; i < json_reader_count_elements(reader); i++)
-    {
-        GtChannelData* data = NULL;
+                if (!err && !data)
+                    decode_missing("channel", &err);
 
-        READ_JSON_ELEMENT(i);
+                if (err)
+                {
+                    gt_channel_data_free(data);
+                    break;
+                }
 
-        data = parse_stream(reader, &err);
+                ret->channels = g_list_prepend(ret->channels, data);
+            }
 
-        CHECK_AND_PROPAGATE_ERROR("Unable to fetch followed streams with oauth token '%s', limit '%d' and offset '%d'",
-            oauth_token, limit, offset);
+            if (err) break;
+        }
+        else if (!decode_skip(scanner, &err))
+            break;
+    }
 
-        ret = g_list_append(ret, data);
+check:
+    CHECK_AND_PROPAGATE_ERROR("Unable to fetch followed channels with name '%s', limit '%d' and offset '%d'",
+        id, limit, offset);
 
-        END_JSON_ELEMENT();
-    }
+    ret->channels = g_list_reverse(ret->channels);
 
     return ret;
 
 error:
-    gt_channel_data_list_free(ret);
+    follows_page_free(ret);
 
     return NULL;
 }
 
-static GList*
-fetch_followed_channels(GtTwitch* self, const gchar* id,
-    gint limit, gint offset, gint* total, GError** error)
-{
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_cmpint(limit, >, 0);
-    g_assert_cmpint(offset, >=, 0);
+static void fetch_follows_page(FollowsFetch* fetch, gboolean streams, gint offset);
 
-    g_autoptr(SoupMessage) msg;
-    g_autoptr(JsonReader) reader;
-    g_autofree gchar* uri;
-    GList* ret = NULL;
+static void
+fetch_follows_page_cb(GObject* source,
+    GAsyncResult* res, gpointer udata)
+{
+    FollowsFetch* fetch = udata;
+    GenericTaskData* params = g_task_get_task_data(G_TASK(res));
+    gboolean streams = params->bool_1;
+    FollowsPage* page = NULL;
     GError* err = NULL;
 
-    uri = g_strdup_printf(FOLLOWED_CHANNELS_URI, id, limit, offset);
+    fetch->pending--;
 
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
+    page = g_task_propagate_pointer(G_TASK(res), &err);
 
-    reader = new_send_message_json(self, msg, &err);
+    if (err)
+    {
+        if (fetch->error)
+            g_error_free(err);
+        else
+            fetch->error = err;
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to fetch followed channels with name '%s', limit '%d' and offset '%d'",
-        id, limit, offset);
+        return;
+    }
 
-    READ_JSON_VALUE("_total", *total);
+    /* NOTE: The first page tells us how many there are, request all
+     * the others at once instead of one after the other */
+    if (params->int_2 == 0 && !fetch->error)
+    {
+        for (gint offset = FOLLOWS_LIMIT; offset < page->total; offset += FOLLOWS_LIMIT)
+            fetch_follows_page(fetch, streams, offset);
+    }
 
-    READ_JSON_MEMBER("follows");
+    if (streams)
+        fetch->streams = g_list_concat(fetch->streams, g_steal_pointer(&page->channels));
+    else
+        fetch->chans = g_list_concat(fetch->chans, g_steal_pointer(&page->channels));
 
-    for (gint i = 0; i < json_reader_count_elements(reader); i++)
-    {
-        GtChannelData* data = NULL;
+    follows_page_free(page);
+}
 
-        READ_JSON_ELEMENT(i);
-        READ_JSON_MEMBER("channel");
+static void
+fetch_follows_page(FollowsFetch* fetch, gboolean streams, gint offset)
+{
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
+    GTask* task = NULL;
+    GenericTaskData* data = NULL;
 
-        data = parse_channel(reader, &err);
+    task = g_task_new(fetch->self, NULL, fetch_follows_page_cb, fetch);
 
-        CHECK_AND_PROPAGATE_ERROR("Unable to fetch followed channels with name '%s', limit '%d' and offset '%d'",
-            id, limit, offset);
+    data = generic_task_data_new();
+    data->int_1 = FOLLOWS_LIMIT;
+    data->int_2 = offset;
+    data->str_1 = g_strdup(streams ? fetch->oauth_token : fetch->id);
+    data->bool_1 = streams;
 
-        ret = g_list_append(ret, data);
+    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-        END_JSON_MEMBER();
-        END_JSON_ELEMENT();
-    }
+    uri = streams ?
+        g_strdup_printf(FOLLOWED_STREAMS_URI, FOLLOWS_LIMIT, offset, fetch->oauth_token) :
+        g_strdup_printf(FOLLOWED_CHANNELS_URI, fetch->id, FOLLOWS_LIMIT, offset);
 
-    return ret;
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
 
-error:
-    gt_channel_data_list_free(ret);
+    fetch->pending++;
 
-    return NULL;
+    send_message_decode_async(fetch->self, msg, task,
+        streams ? decode_followed_streams : decode_followed_channels,
+        (GDestroyNotify) follows_page_free);
+
+    g_object_unref(task);
 }
 
 GList*
@@ -2141,89 +4448,109 @@ gt_twitch_fetch_all_followed_channels(GtTwitch* self,
 {
     g_assert(GT_IS_TWITCH(self));
 
-#define LIMIT 100
-
-    gint total = 0;
-    GList* chans = NULL;
+    FollowsFetch fetch = {.self = self, .id = id, .oauth_token = oauth_token};
+    GMainContext* ctx = g_main_context_new();
+    g_autoptr(GHashTable) live = NULL;
+    g_autoptr(GHashTable) seen = NULL;
     GList* streams = NULL;
+    GList* chans = NULL;
     GList* ret = NULL;
-    GError* err = NULL;
 
-    streams = g_list_concat(streams,
-        fetch_followed_streams(self, oauth_token, LIMIT, 0, &total, &err));
+    /* NOTE: The pages come back on our own context so we can block
+     * here until all of them are in without touching the main loop */
+    g_main_context_push_thread_default(ctx);
+
+    fetch_follows_page(&fetch, TRUE, 0);
+    fetch_follows_page(&fetch, FALSE, 0);
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to fetch all followed channels");
+    while (fetch.pending > 0)
+        g_main_context_iteration(ctx, TRUE);
 
-    if (total > 100)
+    g_main_context_pop_thread_default(ctx);
+    g_main_context_unref(ctx);
+
+    if (fetch.error)
     {
-        for (gint i = 100; i < total; i += 100)
-        {
-            streams = g_list_concat(streams,
-                fetch_followed_streams(self, oauth_token, LIMIT, 0, NULL, &err));
+        WARNINGF("Unable to fetch all followed channels because: %s", fetch.error->message);
 
-            CHECK_AND_PROPAGATE_ERROR("Unable to fetch all followed channels");
-        }
-    }
+        g_propagate_prefixed_error(error, fetch.error, "Unable to fetch all followed channels because: ");
 
-    chans = g_list_concat(chans,
-        fetch_followed_channels(self, id, LIMIT, 0, &total, &err));
+        goto error;
+    }
 
-    CHECK_AND_PROPAGATE_ERROR("Unable to fetch all followed channels");
+    //NOTE: Join on the channel id, live streams replace their offline channel
+    live = g_hash_table_new(g_str_hash, g_str_equal);
+    seen = g_hash_table_new(g_str_hash, g_str_equal);
+    streams = fetch.streams;
+    chans = fetch.chans;
+    fetch.streams = NULL;
+    fetch.chans = NULL;
 
-    if (total > 100)
+    for (GList* l = streams; l != NULL; l = l->next)
     {
-        for (gint i = 100; i < total; i += 100)
-        {
-            chans = g_list_concat(chans,
-                fetch_followed_channels(self, id, LIMIT, 0, NULL, &err));
+        GtChannelData* data = l->data;
 
-            CHECK_AND_PROPAGATE_ERROR("Unable to fetch all followed channels");
+        if (g_hash_table_contains(live, data->id))
+            gt_channel_data_free(data);
+        else
+        {
+            g_hash_table_insert(live, data->id, data);
+            fetch.streams = g_list_prepend(fetch.streams, data);
         }
     }
 
-    //NOTE: Remove duplicates
-    for (GList* l = streams; l != NULL; l = l->next)
+    g_list_free(streams);
+
+    for (GList* l = chans; l != NULL; l = l->next)
     {
-        GList* found = g_list_find_custom(chans, l->data, (GCompareFunc) gt_channel_data_compare);
+        GtChannelData* data = l->data;
+        GtChannelData* stream = g_hash_table_lookup(live, data->id);
 
-        if (!found)
+        if (g_hash_table_contains(seen, data->id))
+            gt_channel_data_free(data);
+        else if (stream)
         {
-            WARNINGF("Unable to fetch all followed channels with id '%s' and oauth token '%s' because: "
-                "A followed stream did not exist as a followed channel", id, oauth_token);
-
-            g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_MISC, "Unable to fetch all followed channels with id '%s' and oauth token '%s' because: "
-                "A followed stream did not exist as a followed channel", id, oauth_token);
+            g_assert_false(data->online);
 
-            goto error;
+            g_hash_table_add(seen, stream->id);
+            gt_channel_data_free(data);
         }
         else
         {
-            g_assert_nonnull(found->data);
-            g_assert_false(((GtChannelData*) found->data)->online);
-
-            gt_channel_data_free(found->data);
-
-            chans = g_list_delete_link(chans, found);
+            g_hash_table_add(seen, data->id);
+            fetch.chans = g_list_prepend(fetch.chans, data);
         }
     }
 
-    chans = g_list_concat(chans, streams);
+    g_list_free(chans);
 
-    for (GList* l = chans; l != NULL; l = l->next)
+    for (GList* l = fetch.streams; l != NULL; l = l->next)
     {
         GtChannelData* data = l->data;
-        GtChannel* chan = gt_channel_new(data);
 
-        ret = g_list_append(ret, chan);
+        if (!g_hash_table_contains(seen, data->id))
+        {
+            WARNINGF("Unable to fetch all followed channels with id '%s' and oauth token '%s' because: "
+                "A followed stream did not exist as a followed channel", id, oauth_token);
+
+            g_set_error(error, GT_TWITCH_ERROR, GT_TWITCH_ERROR_MISC, "Unable to fetch all followed channels with id '%s' and oauth token '%s' because: "
+                "A followed stream did not exist as a followed channel", id, oauth_token);
+
+            goto error;
+        }
     }
 
-    g_list_free(chans); //NOTE: Don't need to free entire list because gt_channel_new takes ownership of the data
+    ret = g_list_concat(g_list_reverse(fetch.chans), g_list_reverse(fetch.streams));
+
+    //NOTE: gt_channel_new takes ownership of the data so the list can be reused
+    for (GList* l = ret; l != NULL; l = l->next)
+        l->data = gt_channel_new(l->data);
 
     return ret;
 
 error:
-    gt_channel_data_list_free(chans);
-    gt_channel_data_list_free(streams);
+    gt_channel_data_list_free(fetch.chans);
+    gt_channel_data_list_free(fetch.streams);
 
     return NULL;
 }
@@ -2271,7 +4598,7 @@ gt_twitch_fetch_all_followed_channels_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, fetch_all_followed_channels_async_cb);
+    run_in_request_pool(task, fetch_all_followed_channels_async_cb);
 
     g_object_unref(task);
 }
@@ -2316,25 +4643,6 @@ error:
     return;
 }
 
-static void
-follow_channel_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
-{
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
-
-    GenericTaskData* data = task_data;
-    GError* err = NULL;
-
-    gt_twitch_follow_channel(GT_TWITCH(source), data->str_1, &err);
-
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, NULL, NULL);
-}
-
 // Not cancellable; hard to guarantee that channel is not followed
 void
 gt_twitch_follow_channel_async(GtTwitch* self, const gchar* chan_name,
@@ -2343,17 +4651,21 @@ gt_twitch_follow_channel_async(GtTwitch* self, const gchar* chan_name,
     g_assert(GT_IS_TWITCH(self));
     g_assert_false(utils_str_empty(chan_name));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
+    const GtOAuthInfo* oauth_info = NULL;
     GTask* task = NULL;
-    GenericTaskData* data = NULL;
 
     task = g_task_new(self, NULL, cb, udata);
 
-    data = generic_task_data_new();
-    data->str_1 = g_strdup(chan_name);
+    oauth_info = gt_app_get_oauth_info(main_app);
 
-    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
+    uri = g_strdup_printf(FOLLOW_CHANNEL_URI,
+        oauth_info->user_name, chan_name, oauth_info->oauth_token);
 
-    g_task_run_in_thread(task, follow_channel_async_cb);
+    msg = soup_message_new(SOUP_METHOD_PUT, uri);
+
+    send_message_json_async(self, msg, NULL, task, NULL, NULL);
 
     g_object_unref(task);
 }
@@ -2396,25 +4708,6 @@ error:
     return;
 }
 
-static void
-unfollow_channel_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
-{
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
-
-    GenericTaskData* data = task_data;
-    GError* err = NULL;
-
-    gt_twitch_unfollow_channel(GT_TWITCH(source), data->str_1, &err);
-
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, NULL, NULL); //NOTE: Just return null as this is a void function
-}
-
 //NOTE: Not cancellable; hard to guarantee that channel is not unfollowed
 void
 gt_twitch_unfollow_channel_async(GtTwitch* self, const gchar* chan_name,
@@ -2423,17 +4716,21 @@ gt_twitch_unfollow_channel_async(GtTwitch* self, const gchar* chan_name,
     g_assert(GT_IS_TWITCH(self));
     g_assert_false(utils_str_empty(chan_name));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
+    const GtOAuthInfo* oauth_info = NULL;
     GTask* task = NULL;
-    GenericTaskData* data = NULL;
 
     task = g_task_new(self, NULL, cb, udata);
 
-    data = generic_task_data_new();
-    data->str_1 = g_strdup(chan_name);
+    oauth_info = gt_app_get_oauth_info(main_app);
 
-    g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
+    uri = g_strdup_printf(UNFOLLOW_CHANNEL_URI,
+        oauth_info->user_name, chan_name, oauth_info->oauth_token);
+
+    msg = soup_message_new(SOUP_METHOD_DELETE, uri);
 
-    g_task_run_in_thread(task, unfollow_channel_async_cb);
+    send_message_json_async(self, msg, NULL, task, NULL, NULL);
 
     g_object_unref(task);
 }
@@ -2546,35 +4843,20 @@ gt_twitch_emoticons_async(GtTwitch* self, const char* emotesets,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, emoticon_images_async_cb);
+    run_in_request_pool(task, emoticon_images_async_cb);
 
     g_object_unref(task);
 }
 
-GtUserInfo*
-gt_twitch_fetch_user_info(GtTwitch* self,
-    const gchar* oauth_token, GError** error)
+static gpointer
+parse_user_info(GtTwitch* self, JsonReader* reader,
+    GenericTaskData* params, GError** error)
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_false(utils_str_empty(oauth_token));
-
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader;
-    g_autofree gchar* uri = NULL;
     GtUserInfo* ret = NULL;
-    GError* err = NULL;
-
-    uri = g_strdup_printf(USER_INFO_URI, oauth_token);
-
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
-
-    reader = new_send_message_json(self, msg, &err);
-
-    CHECK_AND_PROPAGATE_ERROR("Unable to get user info");
 
     ret = gt_user_info_new();
 
-    ret->oauth_token = g_strdup(oauth_token);
+    ret->oauth_token = g_strdup(params->str_1);
 
     READ_JSON_VALUE("_id", ret->id);
     READ_JSON_VALUE("name", ret->name);
@@ -2601,23 +4883,31 @@ error:
     return NULL;
 }
 
-static void
-fetch_user_info_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
+GtUserInfo*
+gt_twitch_fetch_user_info(GtTwitch* self,
+    const gchar* oauth_token, GError** error)
 {
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_false(utils_str_empty(oauth_token));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(JsonReader) reader = NULL;
+    g_autofree gchar* uri = NULL;
+    GenericTaskData params = {.str_1 = (gchar*) oauth_token};
     GError* err = NULL;
-    GenericTaskData* data = task_data;
 
-    GtUserInfo* ret = gt_twitch_fetch_user_info(GT_TWITCH(source), data->str_1, &err);
+    uri = g_strdup_printf(USER_INFO_URI, oauth_token);
 
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) gt_user_info_free);
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    reader = new_send_message_json(self, msg, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to get user info");
+
+    return parse_user_info(self, reader, &params, error);
+
+error:
+    return NULL;
 }
 
 void
@@ -2627,6 +4917,8 @@ gt_twitch_fetch_user_info_async(GtTwitch* self,
 {
     g_assert(GT_IS_TWITCH(self));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
     GTask* task = NULL;
     GenericTaskData* data = generic_task_data_new();
 
@@ -2636,7 +4928,12 @@ gt_twitch_fetch_user_info_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, fetch_user_info_async_cb);
+    uri = g_strdup_printf(USER_INFO_URI, oauth_token);
+
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    send_message_json_async(self, msg, TWITCH_API_VERSION_5, task,
+        parse_user_info, (GDestroyNotify) gt_user_info_free);
 
     g_object_unref(task);
 }
@@ -2653,32 +4950,16 @@ gt_twitch_fetch_user_info_finish(GtTwitch* self,
     return ret;
 }
 
-GtOAuthInfo*
-gt_twitch_fetch_oauth_info(GtTwitch* self,
-    const gchar* oauth_token, GError** error)
-
+static gpointer
+parse_oauth_info(GtTwitch* self, JsonReader* reader,
+    GenericTaskData* params, GError** error)
 {
-    g_assert(GT_IS_TWITCH(self));
-    g_assert_false(utils_str_empty(oauth_token));
-
-    g_autoptr(SoupMessage) msg = NULL;
-    g_autoptr(JsonReader) reader;
-    g_autofree gchar* uri = NULL;
     GtOAuthInfo* ret = NULL;
-    GError* err = NULL;
     gint num_scopes;
 
-    uri = g_strdup_printf(OAUTH_INFO_URI, oauth_token);
-
-    msg = soup_message_new(SOUP_METHOD_GET, uri);
-
-    reader = new_send_message_json(self, msg, &err);
-
-    CHECK_AND_PROPAGATE_ERROR("Unable to get oauth info");
-
     ret = gt_oauth_info_new();
 
-    ret->oauth_token = g_strdup(oauth_token);
+    ret->oauth_token = g_strdup(params->str_1);
 
     READ_JSON_MEMBER("token");
     READ_JSON_VALUE("user_id", ret->user_id);
@@ -2708,23 +4989,31 @@ error:
     return NULL;
 }
 
-static void
-fetch_oauth_info_async_cb(GTask* task, gpointer source,
-    gpointer task_data, GCancellable* cancel)
+GtOAuthInfo*
+gt_twitch_fetch_oauth_info(GtTwitch* self,
+    const gchar* oauth_token, GError** error)
 {
-    g_assert(GT_IS_TWITCH(source));
-    g_assert(G_IS_TASK(task));
-    g_assert_nonnull(task_data);
+    g_assert(GT_IS_TWITCH(self));
+    g_assert_false(utils_str_empty(oauth_token));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autoptr(JsonReader) reader = NULL;
+    g_autofree gchar* uri = NULL;
+    GenericTaskData params = {.str_1 = (gchar*) oauth_token};
     GError* err = NULL;
-    GenericTaskData* data = task_data;
 
-    GtOAuthInfo* ret = gt_twitch_fetch_oauth_info(GT_TWITCH(source), data->str_1, &err);
+    uri = g_strdup_printf(OAUTH_INFO_URI, oauth_token);
 
-    if (err)
-        g_task_return_error(task, err);
-    else
-        g_task_return_pointer(task, ret, (GDestroyNotify) gt_oauth_info_free);
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    reader = new_send_message_json(self, msg, &err);
+
+    CHECK_AND_PROPAGATE_ERROR("Unable to get oauth info");
+
+    return parse_oauth_info(self, reader, &params, error);
+
+error:
+    return NULL;
 }
 
 void
@@ -2734,6 +5023,8 @@ gt_twitch_fetch_oauth_info_async(GtTwitch* self,
 {
     g_assert(GT_IS_TWITCH(self));
 
+    g_autoptr(SoupMessage) msg = NULL;
+    g_autofree gchar* uri = NULL;
     GTask* task = NULL;
     GenericTaskData* data = generic_task_data_new();
 
@@ -2743,7 +5034,12 @@ gt_twitch_fetch_oauth_info_async(GtTwitch* self,
 
     g_task_set_task_data(task, data, (GDestroyNotify) generic_task_data_free);
 
-    g_task_run_in_thread(task, fetch_oauth_info_async_cb);
+    uri = g_strdup_printf(OAUTH_INFO_URI, oauth_token);
+
+    msg = soup_message_new(SOUP_METHOD_GET, uri);
+
+    send_message_json_async(self, msg, TWITCH_API_VERSION_5, task,
+        parse_oauth_info, (GDestroyNotify) gt_oauth_info_free);
 
     g_object_unref(task);
 }
@@ -44,6 +44,7 @@ typedef enum _GtTwitchError
     GT_TWITCH_ERROR_MISC,
     GT_TWITCH_ERROR_SOUP_GENERIC,
     GT_TWITCH_ERROR_SOUP_NOT_FOUND = 404,
+    GT_TWITCH_ERROR_SOUP_TOO_MANY_REQUESTS = 429,
 } GtTwitchError;
 
 #define GT_TWITCH_STREAM_QUALITY_SOURCE "source"
@@ -122,6 +123,9 @@ const GtTwitchStreamData*  gt_twitch_stream_list_filter_quality(GList* list, con
 GList*                     gt_twitch_all_streams(GtTwitch* self, const gchar* channel, GError** error);
 void                       gt_twitch_all_streams_async(GtTwitch* self, const gchar* channel, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
 GList*                     gt_twitch_all_streams_finish(GtTwitch* self, GAsyncResult* result, GError** error);
+GList*                     gt_twitch_cached_streams(GtTwitch* self, const gchar* channel);
+void                       gt_twitch_forget_cached_streams(GtTwitch* self, const gchar* channel);
+void                       gt_twitch_prefetch_streams(GtTwitch* self, const gchar* channel);
 GList*                     gt_twitch_top_channels(GtTwitch* self, gint n, gint offset, const gchar* game, const gchar* language, GError** error);
 void                       gt_twitch_top_channels_async(GtTwitch* self, gint n, gint offset, const gchar* game, const gchar* language, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
 GList*                     gt_twitch_top_games(GtTwitch* self, gint n, gint offset, GError** error);
@@ -139,6 +143,9 @@ GtChannelData*             gt_twitch_fetch_channel_data(GtTwitch* self, const gc
 GtChannel*                 gt_twitch_fetch_channel(GtTwitch* self, const gchar* id, GError** error);
 void                       gt_twitch_fetch_channel_async(GtTwitch* self, const gchar* id, GAsyncReadyCallback cb, GCancellable* cancel, gpointer udata);
 GtChannel*                 gt_twitch_fetch_channel_finish(GtTwitch* self, GAsyncResult* result, GError** error);
+GList*                     gt_twitch_fetch_live_streams(GtTwitch* self, GList* ids, GError** error);
+void                       gt_twitch_fetch_live_streams_async(GtTwitch* self, GList* ids, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
+GList*                     gt_twitch_fetch_live_streams_finish(GtTwitch* self, GAsyncResult* result, GError** error);
 void                       gt_twitch_channel_raw_data_async(GtTwitch* self, const gchar* name, GCancellable* cancel, GAsyncReadyCallback cb, gpointer udata);
 GtGameData*                gt_twitch_game_raw_data(GtTwitch* self, const gchar* name);
 GdkPixbuf*                 gt_twitch_download_picture(GtTwitch* self, const gchar* url, gint64 timestamp, GError** error);
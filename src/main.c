@@ -41,9 +41,6 @@
 #define WHT   "\x1B[37m"
 #define RESET "\x1B[0m"
 
-GtApp* main_app;
-gchar* ORIGINAL_LOCALE;
-
 static void
 gt_log(const gchar* domain,
        gint _level,
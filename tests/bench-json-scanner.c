@@ -0,0 +1,208 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-twitch-decode.h"
+#include <gio/gio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 200
+
+typedef gpointer (*DecodeFunc) (GtJsonScanner* scanner, GError** error);
+typedef gpointer (*ParseFunc) (JsonReader* reader, GError** error);
+
+/* NOTE: One recorded response and where its objects sit, inner is the
+ * member wrapping each object, if any, like "game" in the top games */
+typedef struct
+{
+    const gchar* filename;
+    const gchar* member;
+    const gchar* inner;
+    DecodeFunc decode;
+    ParseFunc parse;
+    GDestroyNotify free;
+} BenchFile;
+
+static gpointer
+decode_element(GtJsonScanner* scanner, const BenchFile* file)
+{
+    const gchar* name = NULL;
+    gpointer ret = NULL;
+
+    if (!file->inner)
+        return file->decode(scanner, NULL);
+
+    while (gt_json_scanner_next_member(scanner, &name, NULL))
+    {
+        if (g_strcmp0(name, file->inner) == 0)
+        {
+            g_assert_true(gt_json_scanner_expect(scanner, GT_JSON_TOKEN_OBJECT_START, NULL));
+
+            ret = file->decode(scanner, NULL);
+        }
+        else
+            g_assert_true(gt_json_scanner_skip(scanner, gt_json_scanner_next(scanner, NULL), NULL));
+    }
+
+    return ret;
+}
+
+/* NOTE: The whole of a request's decode with the scanner, from the body
+ * to the list of data GtTwitch wraps in its objects */
+static guint
+decode_document(const gchar* data, gsize len, const BenchFile* file)
+{
+    GtJsonScanner scanner;
+    const gchar* name = NULL;
+    GList* list = NULL;
+    guint ret;
+
+    gt_json_scanner_init(&scanner, data, len);
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, NULL));
+
+    while (gt_json_scanner_next_member(&scanner, &name, NULL))
+    {
+        if (g_strcmp0(name, file->member) != 0)
+        {
+            g_assert_true(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, NULL), NULL));
+            continue;
+        }
+
+        g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_ARRAY_START, NULL));
+
+        while (gt_json_scanner_next(&scanner, NULL) == GT_JSON_TOKEN_OBJECT_START)
+        {
+            gpointer elem = decode_element(&scanner, file);
+
+            g_assert_nonnull(elem);
+
+            list = g_list_prepend(list, elem);
+        }
+    }
+
+    gt_json_scanner_clear(&scanner);
+
+    ret = g_list_length(list);
+
+    g_list_free_full(list, file->free);
+
+    return ret;
+}
+
+/* NOTE: The same with the json-glib tree the responses used to be read from */
+static guint
+parse_document(const gchar* data, gsize len, const BenchFile* file)
+{
+    g_autoptr(JsonParser) parser = json_parser_new();
+    g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GError) err = NULL;
+    GList* list = NULL;
+    guint ret;
+
+    json_parser_load_from_data(parser, data, len, &err);
+    g_assert_no_error(err);
+
+    reader = json_reader_new(json_parser_get_root(parser));
+
+    g_assert_true(json_reader_read_member(reader, file->member));
+
+    for (gint i = 0; i < json_reader_count_elements(reader); i++)
+    {
+        gpointer elem;
+
+        json_reader_read_element(reader, i);
+        if (file->inner) json_reader_read_member(reader, file->inner);
+
+        elem = file->parse(reader, &err);
+
+        g_assert_no_error(err);
+        g_assert_nonnull(elem);
+
+        list = g_list_prepend(list, elem);
+
+        if (file->inner) json_reader_end_member(reader);
+        json_reader_end_element(reader);
+    }
+
+    json_reader_end_member(reader);
+
+    ret = g_list_length(list);
+
+    g_list_free_full(list, file->free);
+
+    return ret;
+}
+
+static void
+bench_file(const BenchFile* file, gint iterations)
+{
+    g_autofree gchar* path = g_test_build_filename(G_TEST_DIST, "data", file->filename, NULL);
+    g_autofree gchar* contents = NULL;
+    g_autoptr(GError) err = NULL;
+    gint64 start, decoder_time, parser_time;
+    gsize len;
+
+    g_file_get_contents(path, &contents, &len, &err);
+    g_assert_no_error(err);
+
+    //NOTE: Both have to agree on the response before timing them
+    g_assert_cmpuint(decode_document(contents, len, file), ==, parse_document(contents, len, file));
+
+    start = g_get_monotonic_time();
+    for (gint i = 0; i < iterations; i++)
+        decode_document(contents, len, file);
+    decoder_time = (g_get_monotonic_time() - start) / iterations;
+
+    start = g_get_monotonic_time();
+    for (gint i = 0; i < iterations; i++)
+        parse_document(contents, len, file);
+    parser_time = (g_get_monotonic_time() - start) / iterations;
+
+    g_print("%-28s %7" G_GSIZE_FORMAT " bytes  decoder %6" G_GINT64_FORMAT " us  "
+        "json-glib %6" G_GINT64_FORMAT " us  (%.1fx)\n",
+        file->filename, len, decoder_time, parser_time,
+        (gdouble) parser_time / MAX(decoder_time, 1));
+}
+
+int
+main(int argc, char** argv)
+{
+    static const BenchFile files[] =
+    {
+        {"kraken-top-streams.json", "streams", NULL,
+         (DecodeFunc) gt_twitch_decode_stream, (ParseFunc) gt_twitch_parse_stream,
+         (GDestroyNotify) gt_channel_data_free},
+        {"kraken-top-games.json", "top", "game",
+         (DecodeFunc) gt_twitch_decode_game, (ParseFunc) gt_twitch_parse_game,
+         (GDestroyNotify) gt_game_data_free},
+        {"kraken-search-games.json", "games", NULL,
+         (DecodeFunc) gt_twitch_decode_game, (ParseFunc) gt_twitch_parse_game,
+         (GDestroyNotify) gt_game_data_free},
+    };
+    gint iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+
+    g_test_init(&argc, &argv, NULL);
+
+    iterations = MAX(iterations, 1);
+
+    for (guint i = 0; i < G_N_ELEMENTS(files); i++)
+        bench_file(&files[i], iterations);
+
+    return 0;
+}
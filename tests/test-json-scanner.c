@@ -0,0 +1,341 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-json-scanner.h"
+#include <gio/gio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define SCANNER_INIT(scanner, str) gt_json_scanner_init(scanner, str, strlen(str))
+
+/* NOTE: Scans a single string value and returns a copy of it, NULL on error */
+static gchar*
+scan_string(const gchar* json, GError** error)
+{
+    GtJsonScanner scanner;
+    gchar* ret = NULL;
+
+    SCANNER_INIT(&scanner, json);
+
+    if (gt_json_scanner_next(&scanner, error) == GT_JSON_TOKEN_STRING)
+        ret = g_strdup(gt_json_scanner_get_string(&scanner));
+
+    gt_json_scanner_clear(&scanner);
+
+    return ret;
+}
+
+static void
+test_empty(void)
+{
+    GtJsonScanner scanner;
+    g_autoptr(GError) err = NULL;
+
+    gt_json_scanner_init(&scanner, "", 0);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_END);
+    g_assert_no_error(err);
+    gt_json_scanner_clear(&scanner);
+
+    SCANNER_INIT(&scanner, " \n\t ");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_END);
+    g_assert_no_error(err);
+    gt_json_scanner_clear(&scanner);
+}
+
+static void
+test_scalars(void)
+{
+    GtJsonScanner scanner;
+    g_autoptr(GError) err = NULL;
+    const gchar* name = NULL;
+
+    SCANNER_INIT(&scanner, "{\"s\": \"str\", \"i\": -12, \"d\": 1.5e2, \"t\": true, \"f\": false, \"n\": null}");
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "s");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_STRING);
+    g_assert_cmpstr(gt_json_scanner_get_string(&scanner), ==, "str");
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "i");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_NUMBER);
+    g_assert_cmpint(gt_json_scanner_get_int(&scanner), ==, -12);
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "d");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_NUMBER);
+    g_assert_cmpfloat(gt_json_scanner_get_double(&scanner), ==, 150.0);
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "t");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_TRUE);
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "f");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_FALSE);
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "n");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_NULL);
+
+    g_assert_false(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_no_error(err);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_END);
+
+    gt_json_scanner_clear(&scanner);
+}
+
+static void
+test_escapes(void)
+{
+    g_autoptr(GError) err = NULL;
+    g_autofree gchar* simple = scan_string("\"a\\\"b\\\\c\\/d\\be\\ff\\ng\\rh\\ti\"", &err);
+    g_autofree gchar* unicode = scan_string("\"caf\\u00e9 \\u30b9\"", &err);
+    g_autofree gchar* plain = scan_string("\"no escapes at all\"", &err);
+
+    g_assert_no_error(err);
+    g_assert_cmpstr(simple, ==, "a\"b\\c/d\be\ff\ng\rh\ti");
+    g_assert_cmpstr(unicode, ==, "caf\xc3\xa9 \xe3\x82\xb9");
+    g_assert_cmpstr(plain, ==, "no escapes at all");
+
+    g_free(scan_string("\"bad \\q escape\"", &err));
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_clear_error(&err);
+
+    g_free(scan_string("\"bad \\u12g4 hex\"", &err));
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+}
+
+static void
+test_surrogates(void)
+{
+    g_autoptr(GError) err = NULL;
+    g_autofree gchar* emoji = scan_string("\"\\ud83d\\ude00!\"", &err);
+
+    g_assert_no_error(err);
+    g_assert_cmpstr(emoji, ==, "\xf0\x9f\x98\x80!");
+    g_assert_true(g_utf8_validate(emoji, -1, NULL));
+
+    /* NOTE: A high surrogate has to be followed by a low one */
+    g_free(scan_string("\"\\ud83d\"", &err));
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_clear_error(&err);
+
+    g_free(scan_string("\"\\ud83d\\u0041\"", &err));
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_clear_error(&err);
+
+    g_free(scan_string("\"\\ud83dx\"", &err));
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+}
+
+static void
+test_nesting(void)
+{
+    GtJsonScanner scanner;
+    g_autoptr(GError) err = NULL;
+    const gchar* name = NULL;
+    const GtJsonToken expected[] =
+    {
+        GT_JSON_TOKEN_OBJECT_START,
+        GT_JSON_TOKEN_STRING, GT_JSON_TOKEN_ARRAY_START,
+        GT_JSON_TOKEN_NUMBER,
+        GT_JSON_TOKEN_ARRAY_START, GT_JSON_TOKEN_OBJECT_START,
+        GT_JSON_TOKEN_STRING, GT_JSON_TOKEN_ARRAY_START, GT_JSON_TOKEN_ARRAY_END,
+        GT_JSON_TOKEN_OBJECT_END, GT_JSON_TOKEN_ARRAY_END,
+        GT_JSON_TOKEN_ARRAY_END,
+        GT_JSON_TOKEN_OBJECT_END,
+        GT_JSON_TOKEN_END,
+    };
+
+    SCANNER_INIT(&scanner, "{\"a\": [1, [{\"b\": []}]]}");
+
+    for (guint i = 0; i < G_N_ELEMENTS(expected); i++)
+        g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, expected[i]);
+
+    g_assert_no_error(err);
+    gt_json_scanner_clear(&scanner);
+
+    /* NOTE: Member names survive reading the value that follows them */
+    SCANNER_INIT(&scanner, "{\"outer\": {\"inner\": \"value\"}}");
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "outer");
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "inner");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_STRING);
+    g_assert_cmpstr(gt_json_scanner_get_string(&scanner), ==, "value");
+    g_assert_false(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_false(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_no_error(err);
+
+    gt_json_scanner_clear(&scanner);
+}
+
+static void
+test_skip(void)
+{
+    GtJsonScanner scanner;
+    g_autoptr(GError) err = NULL;
+    const gchar* name = NULL;
+
+    SCANNER_INIT(&scanner, "{\"skip\": {\"a\": [1, {\"b\": \"]}\"}], \"c\": {}}, "
+        "\"scalar\": \"x\", \"keep\": 42}");
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "skip");
+    g_assert_true(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, &err), &err));
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "scalar");
+    g_assert_true(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, &err), &err));
+
+    g_assert_true(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_cmpstr(name, ==, "keep");
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_NUMBER);
+    g_assert_cmpint(gt_json_scanner_get_int(&scanner), ==, 42);
+
+    g_assert_false(gt_json_scanner_next_member(&scanner, &name, &err));
+    g_assert_no_error(err);
+
+    gt_json_scanner_clear(&scanner);
+}
+
+static void
+test_truncated(void)
+{
+    const gchar* inputs[] =
+    {
+        "\"unterminated",
+        "\"ends in escape\\",
+        "\"short \\u12",
+        "\"half a pair \\ud83d\\u",
+        "{\"a\": tru",
+        "{\"a\": [1, 2",
+        "{\"a\": {\"b\": {",
+        "[[[",
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(inputs); i++)
+    {
+        GtJsonScanner scanner;
+        g_autoptr(GError) err = NULL;
+
+        SCANNER_INIT(&scanner, inputs[i]);
+
+        g_assert_false(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, &err), &err));
+        g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+
+        gt_json_scanner_clear(&scanner);
+    }
+}
+
+static void
+test_error_offset(void)
+{
+    GtJsonScanner scanner;
+    g_autoptr(GError) err = NULL;
+
+    SCANNER_INIT(&scanner, "[1, @, 3]");
+
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_ARRAY_START);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_NUMBER);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_INVALID);
+    g_assert_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_assert_nonnull(strstr(err->message, "at offset 4"));
+
+    gt_json_scanner_clear(&scanner);
+}
+
+/* NOTE: Walks a whole recorded response and counts the elements of the
+ * array under the given top level member */
+static void
+test_recorded(gconstpointer udata)
+{
+    const gchar* const* args = udata;
+    g_autofree gchar* path = g_test_build_filename(G_TEST_DIST, "data", args[0], NULL);
+    g_autofree gchar* contents = NULL;
+    g_autoptr(GError) err = NULL;
+    GtJsonScanner scanner;
+    const gchar* name = NULL;
+    gint count = -1;
+    gsize len;
+
+    g_file_get_contents(path, &contents, &len, &err);
+    g_assert_no_error(err);
+
+    gt_json_scanner_init(&scanner, contents, len);
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+
+    while (gt_json_scanner_next_member(&scanner, &name, &err))
+    {
+        if (g_strcmp0(name, args[1]) == 0)
+        {
+            GtJsonToken token;
+
+            g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_ARRAY_START, &err));
+
+            count = 0;
+
+            while ((token = gt_json_scanner_next(&scanner, &err)) != GT_JSON_TOKEN_ARRAY_END)
+            {
+                g_assert_true(gt_json_scanner_skip(&scanner, token, &err));
+                count++;
+            }
+        }
+        else
+            g_assert_true(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, &err), &err));
+    }
+
+    g_assert_no_error(err);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_END);
+    g_assert_cmpint(count, ==, atoi(args[2]));
+
+    gt_json_scanner_clear(&scanner);
+}
+
+int
+main(int argc, char** argv)
+{
+    static const gchar* top_streams[] = {"kraken-top-streams.json", "streams", "100"};
+    static const gchar* top_games[] = {"kraken-top-games.json", "top", "48"};
+    static const gchar* search_games[] = {"kraken-search-games.json", "games", "10"};
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/json-scanner/empty", test_empty);
+    g_test_add_func("/json-scanner/scalars", test_scalars);
+    g_test_add_func("/json-scanner/escapes", test_escapes);
+    g_test_add_func("/json-scanner/surrogates", test_surrogates);
+    g_test_add_func("/json-scanner/nesting", test_nesting);
+    g_test_add_func("/json-scanner/skip", test_skip);
+    g_test_add_func("/json-scanner/truncated", test_truncated);
+    g_test_add_func("/json-scanner/error-offset", test_error_offset);
+    g_test_add_data_func("/json-scanner/recorded/top-streams", top_streams, test_recorded);
+    g_test_add_data_func("/json-scanner/recorded/top-games", top_games, test_recorded);
+    g_test_add_data_func("/json-scanner/recorded/search-games", search_games, test_recorded);
+
+    return g_test_run();
+}
@@ -0,0 +1,254 @@
+/*
+ *  This file is part of GNOME Twitch - 'Enjoy Twitch on your GNU/Linux desktop'
+ *  Copyright © 2017 Vincent Szolnoky <vinszent@vinszent.com>
+ *
+ *  GNOME Twitch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GNOME Twitch is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNOME Twitch. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gt-twitch-decode.h"
+#include <gio/gio.h>
+#include <string.h>
+
+typedef gpointer (*DecodeFunc) (GtJsonScanner* scanner, GError** error);
+typedef gpointer (*ParseFunc) (JsonReader* reader, GError** error);
+
+static gchar*
+load_recorded(const gchar* filename, gsize* len)
+{
+    g_autofree gchar* path = g_test_build_filename(G_TEST_DIST, "data", filename, NULL);
+    g_autoptr(GError) err = NULL;
+    gchar* ret = NULL;
+
+    g_file_get_contents(path, &ret, len, &err);
+    g_assert_no_error(err);
+
+    return ret;
+}
+
+/* NOTE: Runs the decoder on every object of the array under the given
+ * top level member, like the GtTwitch requests do */
+static GList*
+decode_recorded(const gchar* filename, const gchar* member, DecodeFunc func)
+{
+    g_autofree gchar* contents = NULL;
+    g_autoptr(GError) err = NULL;
+    GtJsonScanner scanner;
+    const gchar* name = NULL;
+    GList* ret = NULL;
+    gsize len;
+
+    contents = load_recorded(filename, &len);
+
+    gt_json_scanner_init(&scanner, contents, len);
+
+    g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_OBJECT_START, &err));
+
+    while (gt_json_scanner_next_member(&scanner, &name, &err))
+    {
+        GtJsonToken token;
+
+        if (g_strcmp0(name, member) != 0)
+        {
+            g_assert_true(gt_json_scanner_skip(&scanner, gt_json_scanner_next(&scanner, &err), &err));
+            continue;
+        }
+
+        g_assert_true(gt_json_scanner_expect(&scanner, GT_JSON_TOKEN_ARRAY_START, &err));
+
+        while ((token = gt_json_scanner_next(&scanner, &err)) == GT_JSON_TOKEN_OBJECT_START)
+        {
+            gpointer data = func(&scanner, &err);
+
+            g_assert_no_error(err);
+            g_assert_nonnull(data);
+
+            ret = g_list_prepend(ret, data);
+        }
+
+        g_assert_cmpint(token, ==, GT_JSON_TOKEN_ARRAY_END);
+    }
+
+    g_assert_no_error(err);
+    g_assert_cmpint(gt_json_scanner_next(&scanner, &err), ==, GT_JSON_TOKEN_END);
+
+    gt_json_scanner_clear(&scanner);
+
+    return g_list_reverse(ret);
+}
+
+/* NOTE: The same walk through a json-glib tree, the way responses were
+ * read before the scanner */
+static GList*
+parse_recorded(const gchar* filename, const gchar* member, ParseFunc func)
+{
+    g_autofree gchar* contents = NULL;
+    g_autoptr(JsonParser) parser = json_parser_new();
+    g_autoptr(JsonReader) reader = NULL;
+    g_autoptr(GError) err = NULL;
+    GList* ret = NULL;
+    gsize len;
+
+    contents = load_recorded(filename, &len);
+
+    json_parser_load_from_data(parser, contents, len, &err);
+    g_assert_no_error(err);
+
+    reader = json_reader_new(json_parser_get_root(parser));
+
+    g_assert_true(json_reader_read_member(reader, member));
+
+    for (gint i = 0; i < json_reader_count_elements(reader); i++)
+    {
+        gpointer data;
+
+        g_assert_true(json_reader_read_element(reader, i));
+
+        data = func(reader, &err);
+
+        g_assert_no_error(err);
+        g_assert_nonnull(data);
+
+        ret = g_list_prepend(ret, data);
+
+        json_reader_end_element(reader);
+    }
+
+    json_reader_end_member(reader);
+
+    return g_list_reverse(ret);
+}
+
+static void
+assert_date_time(GDateTime* time, gint year, gint month, gint day, gint hour, gint min, gint sec)
+{
+    g_assert_nonnull(time);
+    g_assert_cmpint(g_date_time_get_year(time), ==, year);
+    g_assert_cmpint(g_date_time_get_month(time), ==, month);
+    g_assert_cmpint(g_date_time_get_day_of_month(time), ==, day);
+    g_assert_cmpint(g_date_time_get_hour(time), ==, hour);
+    g_assert_cmpint(g_date_time_get_minute(time), ==, min);
+    g_assert_cmpint(g_date_time_get_second(time), ==, sec);
+}
+
+static void
+test_top_streams(void)
+{
+    GList* streams = decode_recorded("kraken-top-streams.json", "streams",
+        (DecodeFunc) gt_twitch_decode_stream);
+    GtChannelData* data;
+
+    g_assert_cmpuint(g_list_length(streams), ==, 100);
+
+    data = g_list_nth_data(streams, 0);
+    g_assert_cmpstr(data->id, ==, "10000000");
+    g_assert_cmpstr(data->name, ==, "streamer_0");
+    g_assert_cmpstr(data->display_name, ==, "ストリーマー0");
+    g_assert_cmpstr(data->status, ==, "Road to Grandmaster 🔥 !giveaway");
+    g_assert_cmpstr(data->game, ==, "Fortnite");
+    g_assert_cmpint(data->viewers, ==, 120000);
+    assert_date_time(data->stream_started_time, 2017, 10, 18, 10, 0, 11);
+    g_assert_cmpstr(data->preview_url, ==,
+        "https://static-cdn.jtvnw.net/previews-ttv/live_user_streamer_0-640x360.jpg");
+    g_assert_cmpstr(data->video_banner_url, ==,
+        "https://static-cdn.jtvnw.net/jtv_user_pictures/streamer_0-channel_offline_image-1920x1080.jpeg");
+    g_assert_cmpstr(data->logo_url, ==,
+        "https://static-cdn.jtvnw.net/jtv_user_pictures/streamer_0-profile_image-00000000-300x300.png");
+    g_assert_cmpstr(data->profile_url, ==, "https://www.twitch.tv/streamer_0");
+    g_assert_true(data->online);
+
+    //NOTE: A null video banner
+    data = g_list_nth_data(streams, 1);
+    g_assert_cmpstr(data->id, ==, "10000037");
+    g_assert_cmpstr(data->name, ==, "streamer_1");
+    g_assert_cmpstr(data->display_name, ==, "Streamer_1");
+    g_assert_cmpstr(data->status, ==, "Ranked grind w/ viewers | !discord");
+    g_assert_cmpstr(data->game, ==, "IRL");
+    g_assert_cmpint(data->viewers, ==, 60000);
+    assert_date_time(data->stream_started_time, 2017, 10, 18, 11, 1, 11);
+    g_assert_null(data->video_banner_url);
+    g_assert_true(data->online);
+
+    g_list_free_full(streams, (GDestroyNotify) gt_channel_data_free);
+}
+
+static void
+test_streams_match_json_glib(void)
+{
+    GList* decoded = decode_recorded("kraken-top-streams.json", "streams",
+        (DecodeFunc) gt_twitch_decode_stream);
+    GList* parsed = parse_recorded("kraken-top-streams.json", "streams",
+        (ParseFunc) gt_twitch_parse_stream);
+
+    g_assert_cmpuint(g_list_length(decoded), ==, g_list_length(parsed));
+
+    for (GList *d = decoded, *p = parsed; d != NULL; d = d->next, p = p->next)
+    {
+        GtChannelData* a = d->data;
+        GtChannelData* b = p->data;
+
+        g_assert_cmpstr(a->id, ==, b->id);
+        g_assert_cmpstr(a->name, ==, b->name);
+        g_assert_cmpstr(a->display_name, ==, b->display_name);
+        g_assert_cmpstr(a->status, ==, b->status);
+        g_assert_cmpstr(a->game, ==, b->game);
+        g_assert_cmpint(a->viewers, ==, b->viewers);
+        g_assert_true(g_date_time_equal(a->stream_started_time, b->stream_started_time));
+        g_assert_cmpstr(a->preview_url, ==, b->preview_url);
+        g_assert_cmpstr(a->video_banner_url, ==, b->video_banner_url);
+        g_assert_cmpstr(a->logo_url, ==, b->logo_url);
+        g_assert_cmpstr(a->profile_url, ==, b->profile_url);
+        g_assert_cmpint(a->online, ==, b->online);
+    }
+
+    g_list_free_full(decoded, (GDestroyNotify) gt_channel_data_free);
+    g_list_free_full(parsed, (GDestroyNotify) gt_channel_data_free);
+}
+
+static void
+test_games_match_json_glib(void)
+{
+    GList* decoded = decode_recorded("kraken-search-games.json", "games",
+        (DecodeFunc) gt_twitch_decode_game);
+    GList* parsed = parse_recorded("kraken-search-games.json", "games",
+        (ParseFunc) gt_twitch_parse_game);
+
+    g_assert_cmpuint(g_list_length(decoded), ==, 10);
+    g_assert_cmpuint(g_list_length(parsed), ==, 10);
+
+    for (GList *d = decoded, *p = parsed; d != NULL; d = d->next, p = p->next)
+    {
+        GtGameData* a = d->data;
+        GtGameData* b = p->data;
+
+        g_assert_cmpstr(a->id, ==, b->id);
+        g_assert_cmpstr(a->name, ==, b->name);
+        g_assert_cmpstr(a->preview_url, ==, b->preview_url);
+        g_assert_cmpstr(a->logo_url, ==, b->logo_url);
+    }
+
+    g_list_free_full(decoded, (GDestroyNotify) gt_game_data_free);
+    g_list_free_full(parsed, (GDestroyNotify) gt_game_data_free);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/twitch-decode/top-streams", test_top_streams);
+    g_test_add_func("/twitch-decode/streams-match-json-glib", test_streams_match_json_glib);
+    g_test_add_func("/twitch-decode/games-match-json-glib", test_games_match_json_glib);
+
+    return g_test_run();
+}